@@ -0,0 +1,127 @@
+#include "apsp.h"
+#include <algorithm>
+#include <immintrin.h>
+#include <new>
+
+Distance_matrix::Distance_matrix(int vertices) : V(vertices) {
+  stride = (V + tile - 1) / tile * tile;
+  size_t bytes = sizeof(int) * (size_t)stride * stride;
+  // bytes is a multiple of 64, as aligned_alloc wants
+  cells.reset(
+      static_cast<int *>(std::aligned_alloc(64, bytes > 0 ? bytes : 64)));
+  if (!cells) {
+    throw std::bad_alloc();
+  }
+  std::fill(cells.get(), cells.get() + (size_t)stride * stride, infinity);
+}
+
+Distance_matrix initial_distances(const std::vector<std::vector<int>> &adj) {
+  Distance_matrix matrix(adj.size());
+  for (int from = 0; from < matrix.V; from++) {
+    int *row = matrix.row(from);
+    for (int to = 0; to < matrix.V; to++) {
+      if (adj[from][to] != 0) {
+        row[to] = adj[from][to];
+      }
+    }
+    row[from] = 0;
+  }
+  return matrix;
+}
+
+/*
+
+ TILE KERNELS
+
+*/
+
+namespace {
+
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) over one tile, k outermost so the
+// same kernel is correct when c aliases a or b (the diagonal, row and column
+// phases): row k and column k do not change during step k
+void update_tile_scalar(int *c, const int *a, const int *b, int stride) {
+  const int tile = Distance_matrix::tile;
+  for (int k = 0; k < tile; k++) {
+    const int *b_row = b + (long long)k * stride;
+    for (int i = 0; i < tile; i++) {
+      int via = a[(long long)i * stride + k];
+      int *c_row = c + (long long)i * stride;
+      for (int j = 0; j < tile; j++) {
+        c_row[j] = std::min(c_row[j], via + b_row[j]);
+      }
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void
+update_tile_avx2(int *c, const int *a, const int *b, int stride) {
+  const int tile = Distance_matrix::tile;
+  for (int k = 0; k < tile; k++) {
+    const int *b_row = b + (long long)k * stride;
+    for (int i = 0; i < tile; i++) {
+      __m256i via = _mm256_set1_epi32(a[(long long)i * stride + k]);
+      int *c_row = c + (long long)i * stride;
+      for (int j = 0; j < tile; j += 8) {
+        __m256i current = _mm256_load_si256((const __m256i *)(c_row + j));
+        __m256i candidate = _mm256_add_epi32(
+            via, _mm256_load_si256((const __m256i *)(b_row + j)));
+        _mm256_store_si256((__m256i *)(c_row + j),
+                           _mm256_min_epi32(current, candidate));
+      }
+    }
+  }
+}
+
+} // namespace
+
+bool floyd_warshall_uses_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+
+void floyd_warshall(Distance_matrix &matrix, Thread_pool &pool) {
+  const int tile = Distance_matrix::tile;
+  const int tiles = matrix.stride / tile;
+  const int stride = matrix.stride;
+  auto update_tile =
+      floyd_warshall_uses_avx2() ? update_tile_avx2 : update_tile_scalar;
+  auto tile_at = [&](int tile_row, int tile_column) {
+    return matrix.row(tile_row * tile) + tile_column * tile;
+  };
+
+  for (int pivot = 0; pivot < tiles; pivot++) {
+    int *diagonal = tile_at(pivot, pivot);
+    update_tile(diagonal, diagonal, diagonal, stride);
+
+    // row and column of the pivot, 2 * (tiles - 1) independent tiles
+    pool.parallel_for(2 * (tiles - 1), [&](long long begin, long long end,
+                                           int) {
+      for (long long index = begin; index < end; index++) {
+        int other = index % (tiles - 1);
+        other += other >= pivot;
+        if (index < tiles - 1) {
+          int *row_tile = tile_at(pivot, other);
+          update_tile(row_tile, diagonal, row_tile, stride);
+        } else {
+          int *column_tile = tile_at(other, pivot);
+          update_tile(column_tile, column_tile, diagonal, stride);
+        }
+      }
+    });
+
+    // everything else, (tiles - 1)^2 independent min-plus products
+    pool.parallel_for((long long)(tiles - 1) * (tiles - 1),
+                      [&](long long begin, long long end, int) {
+                        for (long long index = begin; index < end; index++) {
+                          int tile_row = index / (tiles - 1);
+                          int tile_column = index % (tiles - 1);
+                          tile_row += tile_row >= pivot;
+                          tile_column += tile_column >= pivot;
+                          update_tile(tile_at(tile_row, tile_column),
+                                      tile_at(tile_row, pivot),
+                                      tile_at(pivot, tile_column), stride);
+                        }
+                      });
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef APSP_H
+#define APSP_H
+
+#include "dijkstra.h"
+#include "thread_pool.h"
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// All pairs distances in one flat buffer. Rows are padded to a whole number
+// of tiles and every row starts on a cache line, padding cells are
+// unreachable so they never win a min.
+class Distance_matrix {
+  struct Free_deleter {
+    void operator()(int *cells) const { std::free(cells); }
+  };
+  std::unique_ptr<int[], Free_deleter> cells;
+
+public:
+  static constexpr int tile = 64;         // tile edge in cells, 16 KB tiles
+  static constexpr int infinity = 1 << 29; // inf + inf still fits in an int
+
+  int V = 0;
+  int stride = 0; // cells per row, multiple of tile
+
+  explicit Distance_matrix(int vertices);
+
+  int *row(int vertex) { return cells.get() + (long long)vertex * stride; }
+  const int *row(int vertex) const {
+    return cells.get() + (long long)vertex * stride;
+  }
+
+  // shortest distance, unreached_distance when there is no path (or it is
+  // infinity or longer) like in the Dijkstras
+  int distance(int from, int to) const {
+    int value = row(from)[to];
+    return value >= infinity ? unreached_distance : value;
+  }
+};
+
+// distances of an adjacency matrix with 0 marking missing edges
+Distance_matrix initial_distances(const std::vector<std::vector<int>> &adj);
+
+// Blocked Floyd-Warshall: for every diagonal tile first the tile itself, then
+// its row and column of tiles, then all remaining tiles as a min-plus product
+// of the two. Tiles of a phase are independent and spread over the pool, the
+// inner kernel uses AVX2 when the cpu has it.
+void floyd_warshall(Distance_matrix &matrix, Thread_pool &pool);
+
+// whether floyd_warshall runs the AVX2 kernel on this machine
+bool floyd_warshall_uses_avx2();
+
+#endif // !APSP_H
@@ -0,0 +1,87 @@
+#include "batch_queries.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+/*
+
+ WORKSPACE
+
+*/
+
+Dijkstra_workspace::Dijkstra_workspace(int vertices)
+    : distances(vertices, unreached_distance), paths(vertices) {}
+
+template <class Adjacency>
+int Dijkstra_workspace::run_on(const Adjacency &graph, int source,
+                               int destination) {
+  distances.begin_search();
+  queue.clear(); // a search that stopped early leaves entries behind
+  if (destination == -1) {
+    dijkstra(graph, source, distances, queue, All_targets(), paths);
+    return distances.unreached;
+  }
+  dijkstra(graph, source, distances, queue, Single_target{destination},
+           paths);
+  return distance(destination);
+}
+
+int Dijkstra_workspace::run(const Csr_graph &graph, int source,
+                            int destination) {
+  return run_on(graph, source, destination);
+}
+
+int Dijkstra_workspace::run(const Compressed_graph &graph, int source,
+                            int destination) {
+  return run_on(graph, source, destination);
+}
+
+std::vector<int> Dijkstra_workspace::path_to(int destination) const {
+  return paths.path_to(destination, distances);
+}
+
+/*
+
+ BATCHES
+
+*/
+
+Batch_solver::Batch_solver(const Csr_graph &graph, int threads)
+    : graph(graph), pool(threads) {
+  for (int worker = 0; worker < pool.size(); worker++) {
+    workspaces.emplace_back(new Dijkstra_workspace(graph.V));
+  }
+}
+
+std::vector<Query_answer>
+Batch_solver::solve_pairs(const std::vector<int_pair> &pairs) {
+  std::vector<Query_answer> answers(pairs.size());
+  std::atomic<size_t> next_query(0);
+
+  pool.run([&](int worker) {
+    Dijkstra_workspace &workspace = *workspaces[worker];
+    for (size_t query = next_query++; query < pairs.size();
+         query = next_query++) {
+      int destination = pairs[query].second;
+      answers[query].distance =
+          workspace.run(graph, pairs[query].first, destination);
+      answers[query].path = workspace.path_to(destination);
+    }
+  });
+  return answers;
+}
+
+void Batch_solver::solve_sources(
+    const std::vector<int> &sources,
+    const std::function<void(int, const Dijkstra_workspace &)> &visit) {
+  std::atomic<size_t> next_query(0);
+
+  pool.run([&](int worker) {
+    Dijkstra_workspace &workspace = *workspaces[worker];
+    for (size_t query = next_query++; query < sources.size();
+         query = next_query++) {
+      workspace.run(graph, sources[query]);
+      visit(query, workspace);
+    }
+  });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef BATCH_QUERIES_H
+#define BATCH_QUERIES_H
+
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "dijkstra.h"
+#include "thread_pool.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Dijkstra state of one worker, reused from query to query. The distances
+// are version stamped (see Stamped_distances in dijkstra.h), so starting a
+// query costs nothing and a query only pays for the vertices it touches.
+class Dijkstra_workspace {
+  Stamped_distances distances;
+  Record_parents paths;
+  Binary_heap_queue queue;
+
+  template <class Adjacency>
+  int run_on(const Adjacency &graph, int source, int destination);
+
+public:
+  explicit Dijkstra_workspace(int vertices);
+
+  // same result as dijkstra_to_others for destination == -1, otherwise
+  // stops as soon as destination is taken from the queue like
+  // dijkstra_to_chosen; returns the distance to destination
+  // (unreached_distance if unreachable or not asked for)
+  int run(const Csr_graph &graph, int source, int destination = -1);
+  // the same search decoding the neighbour lists on the fly
+  int run(const Compressed_graph &graph, int source, int destination = -1);
+
+  int distance(int vertex) const { return distances.get(vertex); }
+  int parent(int vertex) const {
+    bool reached = distances.get(vertex) != distances.unreached;
+    return reached ? paths.parents[vertex] : -1;
+  }
+  std::vector<int> path_to(int destination) const; // source first
+};
+
+struct Query_answer {
+  int distance = unreached_distance; // when there is no path
+  std::vector<int> path;
+};
+
+// Answers many shortest path queries at once. Queries are handed out one at
+// a time to the workers of a thread pool, each worker owning a workspace
+// that lives as long as the solver.
+class Batch_solver {
+  const Csr_graph &graph;
+  Thread_pool pool;
+  std::vector<std::unique_ptr<Dijkstra_workspace>> workspaces;
+
+public:
+  Batch_solver(const Csr_graph &graph, int threads);
+
+  int threads() const { return pool.size(); }
+
+  // (source, destination) pairs, answers in the order of the pairs
+  std::vector<Query_answer> solve_pairs(const std::vector<int_pair> &pairs);
+
+  // one-to-all from every source; visit(query, workspace) runs on the
+  // worker right after the query finished and must be thread safe
+  void solve_sources(
+      const std::vector<int> &sources,
+      const std::function<void(int, const Dijkstra_workspace &)> &visit);
+};
+
+#endif // !BATCH_QUERIES_H
@@ -0,0 +1,734 @@
+#include "batch_queries.h"
+#include "csr_graph.h"
+#include "delta_stepping.h"
+#include "dijkstra.h"
+#include "dijkstra_counters.h"
+#include "graph.h"
+#include "graph_generator.h"
+#include "packed_matrix.h"
+#include "perf_counters.h"
+#include "reorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+/*
+
+ Parameter sweep over graph sizes, densities and representations. Graph
+ generation, construction and every query are timed on their own with
+ steady_clock and nothing is printed inside a timed region.
+
+   graph_bench [--vertices 10,50,100] [--densities 0.25,0.5,0.75,1]
+               [--representations list,matrix,packed,csr]
+               [--queries all,pair,delta,bucket] [--repetitions 10] [--seed 1]
+               [--threads N] [--csv out.csv] [--json out.json]
+               [--records queries.csv] [--perf 1]
+               [--order identity|degree|bfs|cuthill_mckee|partition]
+   graph_bench --compare <baseline.csv|measures.txt> <current.csv>
+               [--threshold 0.1]
+
+ Results are means over the repetitions in microseconds, like measures.txt.
+ --records writes one line per timed query with its Dijkstra operation
+ counts (built with make -B INSTRUMENT=1, -1 otherwise) and, with --perf 1,
+ the cycles and cache misses perf_event_open measured for it (-1 when the
+ kernel has no hardware counters).
+ --order relabels every generated graph (see reorder.h) before the
+ representations are built from it, timed as the generator's reorder.
+ Queries are drawn in the original ids and translated into the new ones,
+ the one-to-all results are translated back and checked against a search
+ on the original labeling.
+ The comparison flags every metric whose mean grew by more than the
+ threshold and exits with 1 if there was any.
+
+*/
+
+namespace {
+
+struct Options {
+  std::vector<int> vertices = {10, 50, 100, 500, 1000};
+  std::vector<double> densities = {0.25, 0.5, 0.75, 1};
+  std::vector<std::string> representations = {"list", "matrix"};
+  std::vector<std::string> queries = {"all", "pair"};
+  int repetitions = 10;
+  unsigned long long seed = 1;
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string csv_path, json_path, records_path;
+  bool perf = false;
+  std::string ordering; // empty keeps the generated ids
+};
+
+// one metric of one configuration, times in microseconds
+struct Result_row {
+  std::string representation;
+  int vertices = 0;
+  double density = 0;
+  // generate, reorder, build, query_all, query_pair, query_delta,
+  // query_bucket
+  std::string metric;
+  int repetitions = 0;
+  double mean = 0, median = 0, min = 0, stddev = 0;
+
+  std::string key() const {
+    std::ostringstream out;
+    out << representation << " |V| = " << vertices << " D = " << density
+        << " " << metric;
+    return out.str();
+  }
+};
+
+// one timed query, for --records
+struct Query_record {
+  std::string representation;
+  int vertices = 0;
+  double density = 0;
+  int repetition = 0;
+  std::string metric;
+  double time = 0; // us
+  Dijkstra_counters counters;
+  long long cycles = -1, cache_misses = -1;
+};
+
+Result_row summarize(const std::string &representation, int vertices,
+                     double density, const std::string &metric,
+                     std::vector<double> samples) {
+  Result_row row;
+  row.representation = representation;
+  row.vertices = vertices;
+  row.density = density;
+  row.metric = metric;
+  row.repetitions = samples.size();
+  if (samples.empty()) {
+    return row;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (double sample : samples) {
+    sum += sample;
+  }
+  row.mean = sum / samples.size();
+  row.min = samples.front();
+  size_t middle = samples.size() / 2;
+  row.median = samples.size() % 2 == 1
+                   ? samples[middle]
+                   : (samples[middle - 1] + samples[middle]) / 2;
+  double squares = 0;
+  for (double sample : samples) {
+    squares += (sample - row.mean) * (sample - row.mean);
+  }
+  row.stddev = std::sqrt(squares / samples.size());
+  return row;
+}
+
+/*
+
+ OPTIONS
+
+*/
+
+std::vector<std::string> split_list(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    if (i + 1 >= argc) {
+      std::cout << "Missing value of " << option << "\n";
+      return false;
+    }
+    std::string value = argv[++i];
+    if (option == "--vertices") {
+      options.vertices.clear();
+      for (auto &item : split_list(value)) {
+        int vertices = std::atoi(item.c_str());
+        if (vertices < 1) {
+          std::cout << "Vertex counts must be at least 1, got " << item
+                    << "\n";
+          return false;
+        }
+        options.vertices.push_back(vertices);
+      }
+    } else if (option == "--densities") {
+      options.densities.clear();
+      for (auto &item : split_list(value)) {
+        options.densities.push_back(std::atof(item.c_str()));
+      }
+    } else if (option == "--representations") {
+      options.representations = split_list(value);
+    } else if (option == "--queries") {
+      options.queries = split_list(value);
+    } else if (option == "--repetitions") {
+      options.repetitions = std::max(1, std::atoi(value.c_str()));
+    } else if (option == "--seed") {
+      options.seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (option == "--threads") {
+      options.threads = std::max(1, std::atoi(value.c_str()));
+    } else if (option == "--csv") {
+      options.csv_path = value;
+    } else if (option == "--json") {
+      options.json_path = value;
+    } else if (option == "--records") {
+      options.records_path = value;
+    } else if (option == "--perf") {
+      options.perf = std::atoi(value.c_str()) != 0;
+    } else if (option == "--order") {
+      if (!is_vertex_ordering(value)) {
+        std::cout << "Unknown ordering " << value << "\n";
+        return false;
+      }
+      options.ordering = value;
+    } else {
+      std::cout << "Unknown option " << option << "\n";
+      return false;
+    }
+  }
+  for (auto &representation : options.representations) {
+    if (representation != "list" && representation != "matrix" &&
+        representation != "packed" && representation != "csr") {
+      std::cout << "Unknown representation " << representation << "\n";
+      return false;
+    }
+  }
+  for (auto &query : options.queries) {
+    if (query != "all" && query != "pair" && query != "delta" &&
+        query != "bucket") {
+      std::cout << "Unknown query kind " << query << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+
+ MEASUREMENTS
+
+*/
+
+// the queries of one representation, built from an edge list; pair returns
+// false when there is no path
+struct Representation {
+  std::function<void(int)> all;
+  std::function<bool(int, int)> pair;
+  std::function<void(int)> delta;  // empty when not supported
+  std::function<void(int)> bucket; // empty when not supported
+  // distances and parents of the latest all query
+  std::function<Sssp_result()> result;
+  // List_graph and Matrix_graph report experiment_unreached for every
+  // distance from it on
+  int distance_limit = unreached_distance;
+  // false for Matrix_graph, whose distances depend on the vertex ids (see
+  // settles_on_first_reach in dijkstra.h)
+  bool exact = true;
+};
+
+// distances translated back from a reordered graph against the ones of the
+// original labeling, parents may differ between equally short paths
+bool same_distances(const std::vector<int> &distances,
+                    const std::vector<int> &reference, int limit) {
+  for (size_t vertex = 0; vertex < distances.size(); vertex++) {
+    if (std::min(distances[vertex], limit) !=
+        std::min(reference[vertex], limit)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Function> double time_us(Function function) {
+  steady_clock::time_point begin = steady_clock::now();
+  function();
+  steady_clock::time_point end = steady_clock::now();
+  return duration<double, std::micro>(end - begin).count();
+}
+
+// List_graph and Matrix_graph are final, the calls through the concrete
+// type are not virtual
+template <class Graph_type>
+Representation bind_graph(int vertices, const std::vector<Edge> &edges,
+                          std::shared_ptr<void> &holder) {
+  Representation representation;
+  auto graph = std::make_shared<Graph_type>(vertices, edges);
+  holder = graph;
+  representation.all = [graph](int source) {
+    graph->dijkstra_to_others(source);
+  };
+  representation.pair = [graph](int source, int destination) {
+    return graph->dijkstra_to_chosen(source, destination) != -1;
+  };
+  representation.result = [graph] {
+    return Sssp_result{graph->latest_distances(), graph->latest_parents()};
+  };
+  representation.distance_limit = experiment_unreached;
+  return representation;
+}
+
+// graph objects stay alive in `holder` as long as the representation
+Representation build(const std::string &name, int vertices,
+                     const std::vector<Edge> &edges, Thread_pool &pool,
+                     std::shared_ptr<void> &holder) {
+  Representation representation;
+  if (name == "list") {
+    representation = bind_graph<List_graph>(vertices, edges, holder);
+  } else if (name == "matrix") {
+    representation = bind_graph<Matrix_graph>(vertices, edges, holder);
+    representation.exact = false;
+  } else if (name == "packed") {
+    auto graph = std::make_shared<Packed_matrix_graph>(vertices, edges);
+    auto latest = std::make_shared<Sssp_result>();
+    holder = std::make_shared<std::pair<std::shared_ptr<Packed_matrix_graph>,
+                                        std::shared_ptr<Sssp_result>>>(
+        graph, latest);
+    representation.all = [graph, latest](int source) {
+      *latest = graph->dijkstra_to_others(source);
+    };
+    representation.result = [latest] { return *latest; };
+    representation.pair = [graph](int source, int destination) {
+      return graph->dijkstra_to_chosen(source, destination) !=
+             unreached_distance;
+    };
+  } else {
+    auto graph = std::make_shared<Csr_graph>(vertices, edges);
+    auto workspace = std::make_shared<Dijkstra_workspace>(vertices);
+    holder = std::make_shared<std::pair<std::shared_ptr<Csr_graph>,
+                                        std::shared_ptr<Dijkstra_workspace>>>(
+        graph, workspace);
+    representation.all = [graph, workspace](int source) {
+      workspace->run(*graph, source);
+    };
+    representation.result = [graph, workspace] {
+      Sssp_result result;
+      for (int vertex = 0; vertex < graph->V; vertex++) {
+        result.distances.push_back(workspace->distance(vertex));
+        result.parents.push_back(workspace->parent(vertex));
+      }
+      return result;
+    };
+    representation.pair = [graph, workspace](int source, int destination) {
+      return workspace->run(*graph, source, destination) != unreached_distance;
+    };
+    int delta = auto_delta(*graph);
+    representation.delta = [graph, delta, &pool](int source) {
+      delta_stepping(*graph, source, delta, pool);
+    };
+    // one-to-all through the Dijkstra core with Dial's buckets
+    int max_weight = graph->max_weight();
+    representation.bucket = [graph, max_weight](int source) {
+      Distance_vector distances(graph->V, unreached_distance);
+      Bucket_queue queue(max_weight);
+      Record_parents paths(graph->V);
+      dijkstra(*graph, source, distances, queue, All_targets(), paths);
+    };
+  }
+  return representation;
+}
+
+bool wanted(const std::vector<std::string> &list, const std::string &item) {
+  return std::find(list.begin(), list.end(), item) != list.end();
+}
+
+std::vector<Result_row> run_benchmarks(const Options &options,
+                                       std::vector<Query_record> &records) {
+  std::vector<Result_row> rows;
+  Thread_pool pool(options.threads);
+  Perf_counters perf;
+  bool sample_perf = options.perf && perf.available();
+  if (options.perf && !perf.available()) {
+    std::cout << "Hardware counters are unavailable, --perf is ignored\n";
+  }
+
+  for (int vertices : options.vertices) {
+    for (double density : options.densities) {
+      long long edge_count = density * ((double)vertices * (vertices - 1)) / 2;
+      std::vector<double> generate, relabel;
+      std::map<std::string, std::map<std::string, std::vector<double>>>
+          samples; // representation -> metric -> times
+
+      for (int repetition = 0; repetition < options.repetitions;
+           repetition++) {
+        unsigned long long seed = options.seed + repetition;
+        std::vector<Edge> edges;
+        generate.push_back(time_us([&] {
+          edges = Graph_generator(vertices, edge_count, seed, options.threads)
+                      .generate();
+        }));
+
+        // the same query vertices for every representation
+        std::mt19937_64 query_rng(seed);
+        std::uniform_int_distribution<int> vertex(0, vertices - 1);
+        int source = vertex(query_rng);
+        std::vector<int_pair> pairs;
+        while (vertices > 1 && pairs.size() < 100) {
+          int first = vertex(query_rng), second = vertex(query_rng);
+          if (first != second) {
+            pairs.emplace_back(first, second);
+          }
+        }
+
+        // with --order the representations see the relabeled edges, the
+        // reference distances are taken before on the original ones
+        bool ordered = !options.ordering.empty();
+        Vertex_order order;
+        std::vector<int> reference(vertices);
+        if (ordered) {
+          Csr_graph original(vertices, edges);
+          Dijkstra_workspace workspace(vertices);
+          workspace.run(original, source);
+          for (int vertex = 0; vertex < vertices; vertex++) {
+            reference[vertex] = workspace.distance(vertex);
+          }
+          relabel.push_back(time_us([&] {
+            order = compute_vertex_order(original, options.ordering);
+            edges = reorder(edges, order);
+          }));
+        }
+        auto to_new = [&](int vertex) {
+          return ordered ? order.to_new(vertex) : vertex;
+        };
+
+        // times one query and keeps its record; perf sampling stays outside
+        // the measured time
+        Query_record record;
+        auto timed_query = [&](const std::string &name,
+                               const std::string &metric,
+                               const std::function<void()> &query) {
+          take_dijkstra_counters();
+          if (sample_perf) {
+            perf.start();
+          }
+          double time = time_us(query);
+          if (sample_perf) {
+            perf.stop();
+          }
+          record = Query_record();
+          record.representation = name;
+          record.vertices = vertices;
+          record.density = density;
+          record.repetition = repetition;
+          record.metric = metric;
+          record.time = time;
+          record.counters = take_dijkstra_counters();
+          record.cycles = sample_perf ? perf.cycles() : -1;
+          record.cache_misses = sample_perf ? perf.cache_misses() : -1;
+          return time;
+        };
+        auto keep_record = [&] {
+          if (!options.records_path.empty()) {
+            records.push_back(record);
+          }
+        };
+
+        for (auto &name : options.representations) {
+          std::shared_ptr<void> holder;
+          Representation representation;
+          samples[name]["build"].push_back(time_us([&] {
+            representation = build(name, vertices, edges, pool, holder);
+          }));
+
+          if (wanted(options.queries, "all")) {
+            samples[name]["query_all"].push_back(
+                timed_query(name, "query_all",
+                            [&] { representation.all(to_new(source)); }));
+            keep_record();
+            if (ordered && representation.exact &&
+                !same_distances(
+                    order.to_original(representation.result()).distances,
+                    reference, representation.distance_limit)) {
+              std::cout << name << " under the " << options.ordering
+                        << " order differs from the original labeling for "
+                           "source "
+                        << source << "\n";
+            }
+          }
+          // like the experiments, only queries that found a path count
+          if (wanted(options.queries, "pair")) {
+            for (auto &pair : pairs) {
+              bool found = false;
+              double time = timed_query(name, "query_pair", [&] {
+                found = representation.pair(to_new(pair.first),
+                                            to_new(pair.second));
+              });
+              if (found) {
+                samples[name]["query_pair"].push_back(time);
+                keep_record();
+                break;
+              }
+            }
+          }
+          // delta-stepping is not a Dijkstra, its counters stay 0
+          if (wanted(options.queries, "delta") && representation.delta) {
+            samples[name]["query_delta"].push_back(
+                timed_query(name, "query_delta",
+                            [&] { representation.delta(to_new(source)); }));
+            keep_record();
+          }
+          if (wanted(options.queries, "bucket") && representation.bucket) {
+            samples[name]["query_bucket"].push_back(
+                timed_query(name, "query_bucket",
+                            [&] { representation.bucket(to_new(source)); }));
+            keep_record();
+          }
+        }
+      }
+
+      rows.push_back(
+          summarize("generator", vertices, density, "generate", generate));
+      if (!relabel.empty()) {
+        rows.push_back(
+            summarize("generator", vertices, density, "reorder", relabel));
+      }
+      for (auto &name : options.representations) {
+        for (auto &metric : samples[name]) {
+          rows.push_back(summarize(name, vertices, density, metric.first,
+                                   metric.second));
+        }
+      }
+      std::cout << "|V| = " << vertices << "\tD = " << density << " done\n";
+    }
+  }
+  return rows;
+}
+
+/*
+
+ OUTPUT
+
+*/
+
+void print_rows(const std::vector<Result_row> &rows) {
+  for (auto &row : rows) {
+    std::printf("%-10s |V| = %-7d D = %-6g %-12s mean %12.3f us  median "
+                "%12.3f us  min %12.3f us  sd %10.3f us\n",
+                row.representation.c_str(), row.vertices, row.density,
+                row.metric.c_str(), row.mean, row.median, row.min, row.stddev);
+  }
+}
+
+bool write_csv(const std::string &path, const std::vector<Result_row> &rows) {
+  std::ofstream file(path);
+  if (!file) {
+    return false;
+  }
+  file << "representation,vertices,density,metric,repetitions,mean_us,"
+          "median_us,min_us,stddev_us\n";
+  file.precision(10);
+  for (auto &row : rows) {
+    file << row.representation << "," << row.vertices << "," << row.density
+         << "," << row.metric << "," << row.repetitions << "," << row.mean
+         << "," << row.median << "," << row.min << "," << row.stddev << "\n";
+  }
+  return bool(file);
+}
+
+bool write_json(const std::string &path, const std::vector<Result_row> &rows) {
+  std::ofstream file(path);
+  if (!file) {
+    return false;
+  }
+  file.precision(10);
+  file << "[\n";
+  for (size_t i = 0; i < rows.size(); i++) {
+    const Result_row &row = rows[i];
+    file << "  {\"representation\": \"" << row.representation
+         << "\", \"vertices\": " << row.vertices
+         << ", \"density\": " << row.density << ", \"metric\": \""
+         << row.metric << "\", \"repetitions\": " << row.repetitions
+         << ", \"mean_us\": " << row.mean << ", \"median_us\": " << row.median
+         << ", \"min_us\": " << row.min << ", \"stddev_us\": " << row.stddev
+         << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+  }
+  file << "]\n";
+  return bool(file);
+}
+
+bool write_records(const std::string &path,
+                   const std::vector<Query_record> &records) {
+  std::ofstream file(path);
+  if (!file) {
+    return false;
+  }
+  file << "representation,vertices,density,repetition,metric,time_us,pushes,"
+          "pops,stale_pops,relaxations,improvements,settled,cycles,"
+          "cache_misses\n";
+  file.precision(10);
+  for (auto &record : records) {
+    const Dijkstra_counters &counters = record.counters;
+    file << record.representation << "," << record.vertices << ","
+         << record.density << "," << record.repetition << "," << record.metric
+         << "," << record.time << "," << counters.pushes << ","
+         << counters.pops << "," << counters.stale_pops << ","
+         << counters.relaxations << "," << counters.improvements << ","
+         << counters.settled << "," << record.cycles << ","
+         << record.cache_misses << "\n";
+  }
+  return bool(file);
+}
+
+/*
+
+ COMPARISON
+
+*/
+
+// csv written by write_csv or the text printed by the shortest_path
+// experiments (measures.txt)
+bool read_results(const std::string &path, std::vector<Result_row> &rows) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  Result_row experiment; // current block of an experiment printout
+  bool in_experiment = false;
+  while (std::getline(file, line)) {
+    char name[16];
+    int vertices;
+    double density, time;
+    if (std::sscanf(line.c_str(), " %15s graph |V| = %d D = %lf", name,
+                    &vertices, &density) == 3) {
+      experiment = Result_row();
+      experiment.representation = std::string(name) == "List" ? "list"
+                                                               : "matrix";
+      experiment.vertices = vertices;
+      experiment.density = density;
+      experiment.repetitions = 1;
+      in_experiment = true;
+      continue;
+    }
+    size_t took = line.find(" took: ");
+    if (in_experiment && took != std::string::npos &&
+        std::sscanf(line.c_str() + took, " took: %lf us", &time) == 1) {
+      Result_row row = experiment;
+      if (line.find("Generating the graph") == 0) {
+        // keyed like graph_bench's generate rows, the list and matrix
+        // experiments both time the same generator so the first one counts
+        row.representation = "generator";
+        row.metric = "generate";
+        if (std::any_of(rows.begin(), rows.end(), [&](const Result_row &other) {
+              return other.key() == row.key();
+            })) {
+          continue;
+        }
+      } else if (line.find("Calculating the shortest path from source to all "
+                           "of the vertices took") == 0) {
+        row.metric = "query_all";
+      } else if (line.find("Calculating the shortest path from source to one "
+                           "of the vertices took") == 0) {
+        row.metric = "query_pair";
+      } else {
+        continue;
+      }
+      row.mean = row.median = row.min = time;
+      rows.push_back(row);
+      continue;
+    }
+
+    std::vector<std::string> fields = split_list(line);
+    if (fields.size() == 9 && fields[0] != "representation") {
+      Result_row row;
+      row.representation = fields[0];
+      row.vertices = std::atoi(fields[1].c_str());
+      row.density = std::atof(fields[2].c_str());
+      row.metric = fields[3];
+      row.repetitions = std::atoi(fields[4].c_str());
+      row.mean = std::atof(fields[5].c_str());
+      row.median = std::atof(fields[6].c_str());
+      row.min = std::atof(fields[7].c_str());
+      row.stddev = std::atof(fields[8].c_str());
+      rows.push_back(row);
+    }
+  }
+  return true;
+}
+
+int compare(const std::string &baseline_path, const std::string &current_path,
+            double threshold) {
+  std::vector<Result_row> baseline, current;
+  if (!read_results(baseline_path, baseline) ||
+      !read_results(current_path, current)) {
+    std::cout << "Could not read the results to compare\n";
+    return 2;
+  }
+  std::map<std::string, Result_row> baseline_by_key;
+  for (auto &row : baseline) {
+    baseline_by_key[row.key()] = row;
+  }
+
+  int regressions = 0, compared = 0;
+  for (auto &row : current) {
+    auto found = baseline_by_key.find(row.key());
+    if (found == baseline_by_key.end() || found->second.mean <= 0) {
+      continue;
+    }
+    compared++;
+    double ratio = row.mean / found->second.mean;
+    const char *verdict = "";
+    if (ratio > 1 + threshold) {
+      verdict = "  REGRESSION";
+      regressions++;
+    } else if (ratio < 1 - threshold) {
+      verdict = "  faster";
+    }
+    std::printf("%-45s %12.3f us -> %12.3f us  x%.3f%s\n", row.key().c_str(),
+                found->second.mean, row.mean, ratio, verdict);
+  }
+  std::cout << compared << " metrics compared, " << regressions
+            << " regressions above " << threshold * 100 << "%\n";
+  return regressions > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc >= 4 && std::string(argv[1]) == "--compare") {
+    double threshold = 0.1;
+    if (argc == 6 && std::string(argv[4]) == "--threshold") {
+      threshold = std::atof(argv[5]);
+    }
+    return compare(argv[2], argv[3], threshold);
+  }
+
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    return 2;
+  }
+  std::vector<Query_record> records;
+  std::vector<Result_row> rows = run_benchmarks(options, records);
+  print_rows(rows);
+  if (!options.csv_path.empty() && !write_csv(options.csv_path, rows)) {
+    std::cout << "Could not write " << options.csv_path << "\n";
+    return 2;
+  }
+  if (!options.json_path.empty() && !write_json(options.json_path, rows)) {
+    std::cout << "Could not write " << options.json_path << "\n";
+    return 2;
+  }
+  if (!options.records_path.empty() &&
+      !write_records(options.records_path, records)) {
+    std::cout << "Could not write " << options.records_path << "\n";
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "compressed_graph.h"
+#include <algorithm>
+#include <sys/mman.h>
+#include <utility>
+
+namespace {
+
+void write_varint(std::vector<unsigned char> &out, unsigned value) {
+  while (value >= 0x80) {
+    out.push_back((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(value);
+}
+
+} // namespace
+
+Compressed_graph::Compressed_graph(const Csr_graph &graph)
+    : V(graph.V), arc_count(graph.arcs()) {
+  weight_base = graph.min_weight();
+  unsigned weight_range = (unsigned)graph.max_weight() - weight_base;
+  while (weight_bits < 32 && (weight_range >> weight_bits) != 0) {
+    weight_bits++;
+  }
+
+  offset_storage.resize(V + 1);
+  byte_storage.reserve(arc_count * 2);
+  std::vector<int_pair> neighbours;
+  std::vector<unsigned char> packed_weights;
+  for (int vertex = 0; vertex < V; vertex++) {
+    offset_storage[vertex] = byte_storage.size();
+    neighbours.clear();
+    for (long long arc = graph.offsets[vertex]; arc < graph.offsets[vertex + 1];
+         arc++) {
+      neighbours.emplace_back(graph.targets[arc], graph.weights[arc]);
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    write_varint(byte_storage, neighbours.size());
+
+    packed_weights.assign((neighbours.size() * weight_bits + 7) / 8, 0);
+    for (size_t i = 0; i < neighbours.size(); i++) {
+      unsigned long long value = neighbours[i].second - weight_base;
+      unsigned long long bit = i * weight_bits;
+      for (int done = 0; done < weight_bits; done++, bit++) {
+        packed_weights[bit / 8] |= ((value >> done) & 1) << (bit % 8);
+      }
+    }
+    byte_storage.insert(byte_storage.end(), packed_weights.begin(),
+                        packed_weights.end());
+
+    int previous = vertex;
+    for (size_t i = 0; i < neighbours.size(); i++) {
+      int difference = neighbours[i].first - previous;
+      write_varint(byte_storage, i > 0 ? (unsigned)difference
+                                       : ((unsigned)difference << 1) ^
+                                             (unsigned)(difference >> 31));
+      previous = neighbours[i].first;
+    }
+  }
+  offset_storage[V] = byte_storage.size();
+  byte_storage.resize(byte_storage.size() + padding, 0);
+  byte_storage.shrink_to_fit();
+  point_to_storage();
+}
+
+Compressed_graph::~Compressed_graph() {
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+Compressed_graph::Compressed_graph(Compressed_graph &&other) noexcept {
+  *this = std::move(other);
+}
+
+Compressed_graph &
+Compressed_graph::operator=(Compressed_graph &&other) noexcept {
+  std::swap(offset_storage, other.offset_storage);
+  std::swap(byte_storage, other.byte_storage);
+  std::swap(mapping, other.mapping);
+  std::swap(mapping_size, other.mapping_size);
+  std::swap(V, other.V);
+  std::swap(arc_count, other.arc_count);
+  std::swap(weight_base, other.weight_base);
+  std::swap(weight_bits, other.weight_bits);
+  std::swap(offsets, other.offsets);
+  std::swap(bytes, other.bytes);
+  return *this;
+}
+
+void Compressed_graph::point_to_storage() {
+  offsets = offset_storage.data();
+  bytes = byte_storage.data();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include "csr_graph.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Compressed adjacency of an undirected graph, for graphs whose CSR does not
+// fit in memory. The neighbour list of vertex v starts at bytes[offsets[v]]:
+//   degree               varint
+//   weights              degree x weight_bits, packed little endian, as
+//                        weight - weight_base, padded to a whole byte
+//   neighbours           sorted by id, varints: the first one as the zigzag
+//                        encoded difference to v, the others as the gap to
+//                        the previous neighbour
+// Varints hold 7 bits per byte, least significant first, the high bit set on
+// every byte but the last. The stream ends with `padding` zero bytes so the
+// weights can be read with one unaligned 8 byte load.
+class Compressed_graph {
+  std::vector<long long> offset_storage;
+  std::vector<unsigned char> byte_storage;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+
+  void point_to_storage();
+
+  static unsigned read_varint(const unsigned char *&position) {
+    unsigned value = *position & 0x7f;
+    for (int shift = 7; *position++ & 0x80; shift += 7) {
+      value |= (unsigned)(*position & 0x7f) << shift;
+    }
+    return value;
+  }
+
+  friend bool map_compressed_graph(const std::string &path,
+                                   Compressed_graph &graph);
+
+public:
+  static constexpr int padding = 8;
+
+  int V = 0;
+  long long arc_count = 0;
+  int weight_base = 0; // smallest weight
+  int weight_bits = 0; // bits of the largest weight - weight_base
+  const long long *offsets = nullptr;    // V + 1 byte positions
+  const unsigned char *bytes = nullptr;  // offsets[V] + padding bytes
+
+  Compressed_graph() = default;
+  explicit Compressed_graph(const Csr_graph &graph);
+  ~Compressed_graph();
+
+  Compressed_graph(const Compressed_graph &) = delete;
+  Compressed_graph &operator=(const Compressed_graph &) = delete;
+  Compressed_graph(Compressed_graph &&other) noexcept;
+  Compressed_graph &operator=(Compressed_graph &&other) noexcept;
+
+  long long arcs() const { return arc_count; }
+  bool is_mapped() const { return mapping != nullptr; }
+  // offsets and the encoded lists
+  size_t memory_bytes() const {
+    return (V + 1) * sizeof(long long) + (V > 0 ? offsets[V] : 0) + padding;
+  }
+
+  // visit(neighbour, weight) for every neighbour, by increasing id
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    const unsigned char *position = bytes + offsets[vertex];
+    unsigned degree = read_varint(position);
+    const unsigned char *packed_weights = position;
+    position += ((unsigned long long)degree * weight_bits + 7) / 8;
+    unsigned long long mask = (1ull << weight_bits) - 1;
+
+    int neighbour = vertex;
+    for (unsigned i = 0; i < degree; i++) {
+      unsigned value = read_varint(position);
+      neighbour += i > 0 ? (int)value : (int)(value >> 1) ^ -(int)(value & 1);
+      unsigned long long bit = (unsigned long long)i * weight_bits, word;
+      std::memcpy(&word, packed_weights + bit / 8, sizeof(word));
+      visit(neighbour, weight_base + (int)((word >> (bit % 8)) & mask));
+    }
+  }
+};
+
+#endif // !COMPRESSED_GRAPH_H
@@ -0,0 +1,90 @@
+#include "csr_graph.h"
+#include <algorithm>
+#include <sys/mman.h>
+#include <utility>
+
+Csr_graph::Csr_graph(int vertices, const std::list<int_pair> *adj)
+    : V(vertices) {
+  offset_storage.resize(V + 1, 0);
+  for (int vertex = 0; vertex < V; vertex++) {
+    offset_storage[vertex + 1] = offset_storage[vertex] + adj[vertex].size();
+  }
+
+  target_storage.reserve(offset_storage[V]);
+  weight_storage.reserve(offset_storage[V]);
+  for (int vertex = 0; vertex < V; vertex++) {
+    for (auto &elem : adj[vertex]) {
+      target_storage.push_back(elem.first);
+      weight_storage.push_back(elem.second);
+    }
+  }
+  point_to_storage();
+}
+
+Csr_graph::Csr_graph(int vertices, const std::vector<Edge> &edges)
+    : V(vertices) {
+  offset_storage.resize(V + 1, 0);
+  for (const Edge &edge : edges) {
+    offset_storage[edge.first_vertex + 1]++;
+    offset_storage[edge.second_vertex + 1]++;
+  }
+  for (int vertex = 0; vertex < V; vertex++) {
+    offset_storage[vertex + 1] += offset_storage[vertex];
+  }
+
+  target_storage.resize(offset_storage[V]);
+  weight_storage.resize(offset_storage[V]);
+  std::vector<long long> next(offset_storage.begin(), offset_storage.end() - 1);
+  for (const Edge &edge : edges) {
+    long long first = next[edge.first_vertex]++;
+    target_storage[first] = edge.second_vertex;
+    weight_storage[first] = edge.weight;
+    long long second = next[edge.second_vertex]++;
+    target_storage[second] = edge.first_vertex;
+    weight_storage[second] = edge.weight;
+  }
+  point_to_storage();
+}
+
+Csr_graph::~Csr_graph() {
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+Csr_graph::Csr_graph(Csr_graph &&other) noexcept { *this = std::move(other); }
+
+Csr_graph &Csr_graph::operator=(Csr_graph &&other) noexcept {
+  std::swap(offset_storage, other.offset_storage);
+  std::swap(target_storage, other.target_storage);
+  std::swap(weight_storage, other.weight_storage);
+  std::swap(mapping, other.mapping);
+  std::swap(mapping_size, other.mapping_size);
+  std::swap(V, other.V);
+  std::swap(arc_count, other.arc_count);
+  std::swap(offsets, other.offsets);
+  std::swap(targets, other.targets);
+  std::swap(weights, other.weights);
+  return *this;
+}
+
+void Csr_graph::point_to_storage() {
+  arc_count = target_storage.size();
+  offsets = offset_storage.data();
+  targets = target_storage.data();
+  weights = weight_storage.data();
+}
+
+int Csr_graph::min_weight() const {
+  if (arc_count == 0) {
+    return 0;
+  }
+  return *std::min_element(weights, weights + arc_count);
+}
+
+int Csr_graph::max_weight() const {
+  if (arc_count == 0) {
+    return 0;
+  }
+  return *std::max_element(weights, weights + arc_count);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph.h"
+#include "graph_generator.h"
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+// Compressed sparse row snapshot of an undirected graph. Every edge is stored
+// in both directions, neighbours of vertex v are
+// targets[offsets[v]] ... targets[offsets[v + 1] - 1] with matching weights.
+// The arrays either live in the graph itself or in a read-only memory
+// mapping of a binary graph file (see graph_io.h), algorithms only see the
+// pointers.
+class Csr_graph {
+  std::vector<long long> offset_storage;
+  std::vector<int> target_storage;
+  std::vector<int> weight_storage;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+
+  void point_to_storage();
+
+  friend bool map_binary_graph(const std::string &path, Csr_graph &graph);
+
+public:
+  int V = 0;
+  long long arc_count = 0;
+  const long long *offsets = nullptr; // V + 1 entries
+  const int *targets = nullptr;       // arc_count entries
+  const int *weights = nullptr;       // arc_count entries
+
+  Csr_graph() = default;
+  Csr_graph(int vertices, const std::list<int_pair> *adj);
+  // neighbours keep the order of the edge list, like insert_edge would
+  Csr_graph(int vertices, const std::vector<Edge> &edges);
+  ~Csr_graph();
+
+  Csr_graph(const Csr_graph &) = delete;
+  Csr_graph &operator=(const Csr_graph &) = delete;
+  Csr_graph(Csr_graph &&other) noexcept;
+  Csr_graph &operator=(Csr_graph &&other) noexcept;
+
+  long long arcs() const { return arc_count; }
+  bool is_mapped() const { return mapping != nullptr; }
+  int min_weight() const;
+  int max_weight() const;
+
+  // visit(neighbour, weight) for every neighbour, same interface as
+  // Compressed_graph
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    for (long long arc = offsets[vertex]; arc < offsets[vertex + 1]; arc++) {
+      visit(targets[arc], weights[arc]);
+    }
+  }
+};
+
+#endif // !CSR_GRAPH_H
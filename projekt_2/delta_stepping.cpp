@@ -0,0 +1,151 @@
+#include "delta_stepping.h"
+#include "dijkstra.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+// lowers distances[vertex] to candidate, true if this call did it
+bool relax(std::vector<std::atomic<int>> &distances, int vertex,
+           int candidate) {
+  int current = distances[vertex].load(std::memory_order_relaxed);
+  while (candidate < current) {
+    if (distances[vertex].compare_exchange_weak(current, candidate,
+                                                std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+int auto_delta(const Csr_graph &graph) {
+  if (graph.V == 0 || graph.arcs() == 0) {
+    return 1;
+  }
+  int lightest = graph.min_weight();
+  int heaviest = graph.max_weight();
+  double average_degree = (double)graph.arcs() / graph.V;
+  int delta = std::ceil(heaviest / average_degree);
+  return std::max(lightest, std::min(heaviest, delta));
+}
+
+Sssp_result delta_stepping(const Csr_graph &graph, int source, int delta,
+                           Thread_pool &pool) {
+  const int V = graph.V;
+  const int threads = pool.size();
+  std::vector<std::atomic<int>> distances(V);
+  for (auto &distance : distances) {
+    distance.store(unreached_distance, std::memory_order_relaxed);
+  }
+  distances[source].store(0, std::memory_order_relaxed);
+
+  // bucket i holds distances [i * delta, (i + 1) * delta), added as
+  // distances grow
+  std::vector<std::vector<int>> buckets(1);
+  buckets[0].push_back(source);
+
+  std::vector<std::vector<int>> lowered(threads); // per worker relax results
+  std::vector<int> queued_phase(V, -1);  // last phase a vertex was taken in
+  std::vector<int> settled_bucket(V, -1); // last bucket a vertex was settled in
+  std::vector<int> frontier, settled;
+  int phase = 0;
+
+  // relaxes either the light or the heavy edges of the given vertices
+  auto relax_edges = [&](const std::vector<int> &vertices, bool light) {
+    pool.parallel_for(vertices.size(), [&](long long begin, long long end,
+                                           int worker) {
+      for (long long i = begin; i < end; i++) {
+        int vertex = vertices[i];
+        int distance = distances[vertex].load(std::memory_order_relaxed);
+        for (long long e = graph.offsets[vertex]; e < graph.offsets[vertex + 1];
+             e++) {
+          int weight = graph.weights[e];
+          if ((weight <= delta) != light) {
+            continue;
+          }
+          // summed wide, distance + weight may pass INT_MAX
+          long long candidate = (long long)distance + weight;
+          if (candidate < unreached_distance &&
+              relax(distances, graph.targets[e], (int)candidate)) {
+            lowered[worker].push_back(graph.targets[e]);
+          }
+        }
+      }
+    });
+    for (auto &vertices_lowered : lowered) {
+      for (int vertex : vertices_lowered) {
+        size_t bucket =
+            distances[vertex].load(std::memory_order_relaxed) / delta;
+        if (bucket >= buckets.size()) {
+          buckets.resize(bucket + 1);
+        }
+        buckets[bucket].push_back(vertex);
+      }
+      vertices_lowered.clear();
+    }
+  };
+
+  for (size_t bucket = 0; bucket < buckets.size(); bucket++) {
+    settled.clear();
+    while (!buckets[bucket].empty()) {
+      frontier.clear();
+      // stale entries were lowered into an earlier bucket meanwhile,
+      // duplicates come from several relaxations of one vertex
+      for (int vertex : buckets[bucket]) {
+        int distance = distances[vertex].load(std::memory_order_relaxed);
+        if ((size_t)(distance / delta) != bucket ||
+            queued_phase[vertex] == phase) {
+          continue;
+        }
+        queued_phase[vertex] = phase;
+        frontier.push_back(vertex);
+        if (settled_bucket[vertex] != (int)bucket) {
+          settled_bucket[vertex] = bucket;
+          settled.push_back(vertex);
+        }
+      }
+      buckets[bucket].clear();
+      phase++;
+      relax_edges(frontier, true);
+    }
+    relax_edges(settled, false);
+  }
+
+  Sssp_result result;
+  result.distances.resize(V);
+  for (int vertex = 0; vertex < V; vertex++) {
+    result.distances[vertex] = distances[vertex].load(std::memory_order_relaxed);
+  }
+
+  // Dijkstra settles vertices in (distance, id) order and only replaces a
+  // parent on a strict improvement, so the first tight neighbour wins
+  result.parents.assign(V, -1);
+  pool.parallel_for(V, [&](long long begin, long long end, int) {
+    for (long long vertex = begin; vertex < end; vertex++) {
+      int distance = result.distances[vertex];
+      if (vertex == source || distance == unreached_distance) {
+        continue;
+      }
+      int best = -1;
+      for (long long e = graph.offsets[vertex]; e < graph.offsets[vertex + 1];
+           e++) {
+        int neighbour = graph.targets[e];
+        if ((long long)result.distances[neighbour] + graph.weights[e] !=
+            distance) {
+          continue;
+        }
+        if (best == -1 ||
+            result.distances[neighbour] < result.distances[best] ||
+            (result.distances[neighbour] == result.distances[best] &&
+             neighbour < best)) {
+          best = neighbour;
+        }
+      }
+      result.parents[vertex] = best;
+    }
+  });
+  return result;
+}
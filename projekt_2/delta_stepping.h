@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+#include <vector>
+
+// distances and shortest path tree parents in the same convention as
+// dijkstra_to_others, except that unreached vertices keep unreached_distance
+// of dijkstra.h, and parent -1
+struct Sssp_result {
+  std::vector<int> distances;
+  std::vector<int> parents;
+};
+
+// bucket width following Meyer & Sanders, max weight / average degree,
+// clamped to the weight range of the graph
+int auto_delta(const Csr_graph &graph);
+
+// Single source shortest paths by delta-stepping. Vertices are kept in
+// buckets of width delta, light edges (weight <= delta) of a bucket are
+// relaxed in parallel until the bucket stays empty, heavy edges once per
+// bucket afterwards. Parents are chosen like in the sequential Dijkstra, as
+// the tight neighbour with the smallest (distance, id), so both the distances
+// and the parents vector match dijkstra_to_others.
+Sssp_result delta_stepping(const Csr_graph &graph, int source, int delta,
+                           Thread_pool &pool);
+
+#endif // !DELTA_STEPPING_H
@@ -0,0 +1,292 @@
+#pragma once
+
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+#include "dijkstra_counters.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <list>
+#include <utility>
+#include <vector>
+
+typedef std::pair<int, int> int_pair;
+
+/*
+
+ Single source shortest paths core shared by every representation. The
+ search is put together at compile time from five policies, so each
+ combination is one function with the neighbour loop and the queue inlined:
+
+   Adjacency  for_each_neighbour(vertex, visit(neighbour, weight))
+              List_adjacency, Matrix_adjacency, Csr_graph, Compressed_graph,
+              Packed_matrix_graph
+   Queue      push(distance, vertex), pop() -> (distance, vertex), empty()
+              Binary_heap_queue, Bucket_queue
+   Target     reached(vertex), true stops the search when vertex is popped
+              All_targets, Single_target
+   Paths      reach(vertex, parent) for every improved distance
+              Record_parents, No_paths
+   Distances  get(vertex), set(vertex, distance) and the unreached value
+              Distance_vector, Stamped_distances
+
+ Unreached vertices keep the unreached value of the distances:
+ unreached_distance everywhere but in the List_graph / Matrix_graph
+ experiments, which keep experiment_unreached and so never report a distance
+ of experiment_unreached or more. Operation counts go to dijkstra_counters.h
+ when it is compiled in.
+
+*/
+
+const int unreached_distance = INT_MAX;
+// the experiments' historical limit, only where their results are printed or
+// compared
+const int experiment_unreached = 999;
+
+/*
+
+ ADJACENCY
+
+*/
+
+// neighbours in insertion order, as List_graph stores them
+struct List_adjacency {
+  const std::list<int_pair> *adj;
+
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    for (auto &elem : adj[vertex]) {
+      visit(elem.first, elem.second);
+    }
+  }
+};
+
+// every cell of the row, 0 is no edge
+struct Matrix_adjacency {
+  const std::vector<std::vector<int>> *adj;
+
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    const std::vector<int> &row = (*adj)[vertex];
+    for (int neighbour = 0; neighbour < (int)row.size(); neighbour++) {
+      if (row[neighbour] != 0) {
+        visit(neighbour, row[neighbour]);
+      }
+    }
+  }
+};
+
+// Matrix_graph's Dijkstra has always ignored vertices that already have a
+// distance, so the first distance a vertex gets is final there. Kept to
+// reproduce its results, every other adjacency runs the exact search.
+template <class Adjacency> constexpr bool settles_on_first_reach = false;
+template <> constexpr bool settles_on_first_reach<Matrix_adjacency> = true;
+
+/*
+
+ QUEUES
+
+*/
+
+// binary min-heap of (distance, vertex) with lazy deletion, pops equal
+// distances by vertex id like std::priority_queue with std::greater
+class Binary_heap_queue {
+  std::vector<int_pair> heap;
+
+public:
+  bool empty() const { return heap.empty(); }
+  void clear() { heap.clear(); }
+  void push(int distance, int vertex) {
+    heap.emplace_back(distance, vertex);
+    std::push_heap(heap.begin(), heap.end(), std::greater<int_pair>());
+  }
+  int_pair pop() {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<int_pair>());
+    int_pair top = heap.back();
+    heap.pop_back();
+    return top;
+  }
+};
+
+// Dial's buckets for integer weights up to max_weight: max_weight + 1
+// buckets used as a ring, push and pop in O(1). Vertices of equal distance
+// come out in no particular order, so the distances match the heap but a
+// parent may be another tight neighbour.
+class Bucket_queue {
+  std::vector<std::vector<int>> buckets;
+  int current = 0; // distance of the bucket pop looks at
+  long long size = 0;
+
+public:
+  explicit Bucket_queue(int max_weight)
+      : buckets(std::max(1, max_weight + 1)) {}
+
+  bool empty() const { return size == 0; }
+  void clear() {
+    for (auto &bucket : buckets) {
+      bucket.clear();
+    }
+    current = 0;
+    size = 0;
+  }
+  // distance must lie in [last popped, last popped + max_weight]
+  void push(int distance, int vertex) {
+    buckets[distance % buckets.size()].push_back(vertex);
+    size++;
+  }
+  int_pair pop() {
+    while (buckets[current % buckets.size()].empty()) {
+      current++;
+    }
+    std::vector<int> &bucket = buckets[current % buckets.size()];
+    int vertex = bucket.back();
+    bucket.pop_back();
+    size--;
+    return int_pair(current, vertex);
+  }
+};
+
+/*
+
+ TARGETS AND PATHS
+
+*/
+
+struct All_targets {
+  bool reached(int) const { return false; }
+};
+
+struct Single_target {
+  int destination;
+  bool reached(int vertex) const { return vertex == destination; }
+};
+
+// parents of reached vertices, -1 for the source; entries of vertices the
+// latest search did not reach are left from earlier searches
+struct Record_parents {
+  std::vector<int> parents;
+
+  explicit Record_parents(int vertices) : parents(vertices, -1) {}
+  void reach(int vertex, int parent) { parents[vertex] = parent; }
+  // source first, empty when destination was not reached
+  template <class Distances>
+  std::vector<int> path_to(int destination, const Distances &distances) const {
+    std::vector<int> path;
+    if (distances.get(destination) == distances.unreached) {
+      return path;
+    }
+    for (int curr = destination; curr != -1; curr = parents[curr]) {
+      path.push_back(curr);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+};
+
+struct No_paths {
+  void reach(int, int) {}
+};
+
+/*
+
+ DISTANCES
+
+*/
+
+// one entry per vertex, every one unreached up front
+struct Distance_vector {
+  std::vector<int> values;
+  int unreached;
+
+  Distance_vector(int vertices, int unreached)
+      : values(vertices, unreached), unreached(unreached) {}
+  int get(int vertex) const { return values[vertex]; }
+  void set(int vertex, int distance) { values[vertex] = distance; }
+};
+
+// Distances reused from search to search. An entry is valid only while its
+// stamp equals the current search, so starting a search costs nothing and a
+// search only pays for the vertices it touches.
+class Stamped_distances {
+  std::vector<unsigned> stamp;
+  std::vector<int> values;
+  unsigned current = 0;
+
+public:
+  int unreached;
+
+  Stamped_distances(int vertices, int unreached)
+      : stamp(vertices, 0), values(vertices), unreached(unreached) {}
+
+  // forgets every distance of the previous search
+  void begin_search() {
+    current++;
+    // after 2^32 searches old stamps could look valid again
+    if (current == 0) {
+      std::fill(stamp.begin(), stamp.end(), 0);
+      current = 1;
+    }
+  }
+  int get(int vertex) const {
+    return stamp[vertex] == current ? values[vertex] : unreached;
+  }
+  void set(int vertex, int distance) {
+    stamp[vertex] = current;
+    values[vertex] = distance;
+  }
+};
+
+/*
+
+ SEARCH
+
+*/
+
+// every vertex has to be unreached in `distances` and `queue` be empty
+template <class Adjacency, class Distances, class Queue, class Target,
+          class Paths>
+void dijkstra(const Adjacency &graph, int source, Distances &distances,
+              Queue &queue, const Target &target, Paths &paths) {
+  distances.set(source, 0);
+  paths.reach(source, -1);
+  queue.push(0, source);
+  DIJKSTRA_COUNT(pushes);
+
+  while (!queue.empty()) {
+    int_pair top = queue.pop();
+    int min_distance = top.first;
+    int min_distance_vertex = top.second;
+    DIJKSTRA_COUNT(pops);
+
+    if (target.reached(min_distance_vertex)) {
+      DIJKSTRA_COUNT(settled);
+      break;
+    }
+    // outdated entry, the vertex was already taken with a smaller distance
+    if (min_distance > distances.get(min_distance_vertex)) {
+      DIJKSTRA_COUNT(stale_pops);
+      continue;
+    }
+    DIJKSTRA_COUNT(settled);
+
+    graph.for_each_neighbour(min_distance_vertex, [&](int vertex, int weight) {
+      DIJKSTRA_COUNT(relaxations);
+      if (settles_on_first_reach<Adjacency> &&
+          distances.get(vertex) != distances.unreached) {
+        return;
+      }
+      // summed wide, min_distance + weight may pass INT_MAX
+      long long next_check = (long long)min_distance + weight;
+      if (distances.get(vertex) > next_check) {
+        distances.set(vertex, (int)next_check);
+        paths.reach(vertex, min_distance_vertex);
+        queue.push((int)next_check, vertex);
+        DIJKSTRA_COUNT(improvements);
+        DIJKSTRA_COUNT(pushes);
+      }
+    });
+  }
+}
+
+#endif // !DIJKSTRA_H
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef DIJKSTRA_COUNTERS_H
+#define DIJKSTRA_COUNTERS_H
+
+// Operation counts of the Dijkstra searches (dijkstra.h and
+// Dijkstra_workspace). Counting is compiled in only with
+// -DDIJKSTRA_INSTRUMENTATION (make -B INSTRUMENT=1); without it
+// DIJKSTRA_COUNT expands to nothing and the searches compile to exactly the
+// code they had before they were instrumented.
+struct Dijkstra_counters {
+  long long pushes = 0;       // queue insertions, the source included
+  long long pops = 0;         // queue removals
+  long long stale_pops = 0;   // removals of outdated (lazily deleted) entries
+  long long relaxations = 0;  // edges looked at from a settled vertex
+  long long improvements = 0; // relaxations that lowered a distance
+  long long settled = 0;      // vertices taken with their final distance
+};
+
+#ifdef DIJKSTRA_INSTRUMENTATION
+
+constexpr bool dijkstra_instrumentation = true;
+// per thread, so concurrent searches of a Batch_solver do not share lines
+inline thread_local Dijkstra_counters dijkstra_counters;
+#define DIJKSTRA_COUNT(counter) (dijkstra_counters.counter++)
+
+#else
+
+constexpr bool dijkstra_instrumentation = false;
+#define DIJKSTRA_COUNT(counter) ((void)0)
+
+#endif
+
+// counts of the calling thread since the previous call, every field -1 when
+// counting is compiled out
+inline Dijkstra_counters take_dijkstra_counters() {
+#ifdef DIJKSTRA_INSTRUMENTATION
+  Dijkstra_counters counters = dijkstra_counters;
+  dijkstra_counters = Dijkstra_counters();
+  return counters;
+#else
+  return Dijkstra_counters{-1, -1, -1, -1, -1, -1};
+#endif
+}
+
+#endif // !DIJKSTRA_COUNTERS_H
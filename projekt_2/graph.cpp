@@ -1,8 +1,15 @@
 #include "graph.h"
+#include "apsp.h"
+#include "batch_queries.h"
+#include "csr_graph.h"
+#include "delta_stepping.h"
+#include "dijkstra.h"
+#include "packed_matrix.h"
+#include "spt_cache.h"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <queue>
+#include <thread>
 #include <utility>
 
 typedef std::pair<int, int> int_pair;
@@ -17,6 +24,12 @@ using namespace std::chrono;
 std::random_device dev;
 std::mt19937 rng(dev());
 
+Graph::Graph(int vertices, float density_percent, long long seed)
+    : V(vertices), density_percent(density_percent) {
+  this->seed = seed == -1 ? dev() : seed;
+  rng.seed(this->seed);
+}
+
 int Graph::value_gen(char type, int vertices_number) {
   int value = -1;
   switch (type) {
@@ -36,13 +49,169 @@ int Graph::value_gen(char type, int vertices_number) {
   return value;
 }
 
+std::vector<Edge> Graph::generate_edges(int test) {
+  steady_clock::time_point begin = steady_clock::now();
+  Graph_generator generator(V, calculate_edges(), seed + test,
+                            std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<Edge> edges = generator.generate();
+  steady_clock::time_point end = steady_clock::now();
+  time_for_generation += duration<double, std::micro>(end - begin).count();
+  return edges;
+}
+
+bool Graph::matches_last_search(int vertex, int distance, int parent) const {
+  if (distance >= experiment_unreached) {
+    distance = experiment_unreached;
+    parent = -1;
+  }
+  return distance == last_distances[vertex] && parent == last_parents[vertex];
+}
+
+void Graph::measure_spt_cache() {
+  const int sources = 4, updates = 32;
+  Spt_cache cache(*this, 64 << 20);
+  std::vector<int> cached_sources;
+  for (int i = 0; i < sources; i++) {
+    cached_sources.push_back(value_gen('v', V));
+    cache.tree(cached_sources.back());
+  }
+
+  double repair = 0, recompute = 0;
+  for (int update = 0; update < updates && V > 1; update++) {
+    int first_vertex = value_gen('v', V);
+    int second_vertex = value_gen('v', V);
+    while (first_vertex == second_vertex) {
+      second_vertex = value_gen('v', V);
+    }
+    // existing edges are removed every third time, otherwise reweighted
+    int weight = value_gen('w');
+    if (edge_weight(first_vertex, second_vertex) != 0 && update % 3 == 0) {
+      weight = 0;
+    }
+
+    steady_clock::time_point begin = steady_clock::now();
+    cache.update_edge(first_vertex, second_vertex, weight);
+    for (int source : cached_sources) {
+      cache.tree(source);
+    }
+    steady_clock::time_point end = steady_clock::now();
+    repair += duration<double, std::micro>(end - begin).count();
+
+    std::vector<Shortest_path_tree> fresh;
+    begin = steady_clock::now();
+    for (int source : cached_sources) {
+      fresh.push_back(cache.compute(source));
+    }
+    end = steady_clock::now();
+    recompute += duration<double, std::micro>(end - begin).count();
+
+    for (const Shortest_path_tree &tree : fresh) {
+      const Shortest_path_tree &repaired = cache.tree(tree.source);
+      if (tree.distances != repaired.distances ||
+          tree.parents != repaired.parents) {
+        std::cout << "Repaired shortest path tree of source " << tree.source
+                  << " differs from the recomputed one after update "
+                  << update << "\n";
+      }
+    }
+  }
+  time_for_repair += repair / updates;
+  time_for_recompute += recompute / updates;
+}
+
 void Graph::print_measures_mean() {
+  std::cout << "Generating the graph took: "
+            << arithmetic_mean(time_for_generation) << " us\n";
   std::cout << "Calculating the shortest path from source to all of the "
                "vertices took: "
             << arithmetic_mean(time_for_all) << " us\n";
   std::cout << "Calculating the shortest path from source to one of the "
                "vertices took: "
             << arithmetic_mean(time_for_two) << " us\n";
+  std::cout << "Updating one edge and querying 4 cached shortest path trees "
+               "took: "
+            << arithmetic_mean(time_for_repair) << " us, recomputing them took: "
+            << arithmetic_mean(time_for_recompute) << " us\n";
+}
+
+template <class Adjacency>
+double Graph::timed_dijkstra_to_others(const Adjacency &adjacency,
+                                       int source) {
+  steady_clock::time_point begin = steady_clock::now();
+  Binary_heap_queue queue;
+  Distance_vector distances(V, experiment_unreached);
+  Record_parents paths(V);
+  dijkstra(adjacency, source, distances, queue, All_targets(), paths);
+  // printing stays out of the measured time
+  steady_clock::time_point end = steady_clock::now();
+
+  if (print_paths && V <= 10 && number_of_tests == 1) {
+    printf(
+        "\nPaths and distances from source vertex %d to all other vertices:\n",
+        source);
+    for (int i = 0; i < V; ++i) {
+      if (i != source) {
+        std::vector<int> path;
+        for (int curr = i; curr != -1; curr = paths.parents[curr]) {
+          path.push_back(curr);
+        }
+        std::reverse(path.begin(), path.end());
+        printf("Vertex %d: Distance = %d, Path: ", i, distances.values[i]);
+        for (int vertex : path) {
+          printf("%d -> ", vertex);
+        }
+        printf("and back\n");
+      }
+    }
+  }
+
+  last_distances = std::move(distances.values);
+  last_parents = std::move(paths.parents);
+  return duration<double, std::micro>(end - begin).count();
+}
+
+template <class Adjacency>
+double Graph::timed_dijkstra_to_chosen(const Adjacency &adjacency, int source,
+                                       int destination) {
+  // ensuring that different vertices were chosen
+  while (destination == source) {
+    source = value_gen('v', V);
+  }
+
+  steady_clock::time_point begin = steady_clock::now();
+  Binary_heap_queue queue;
+  Distance_vector distances(V, experiment_unreached);
+  Record_parents paths(V);
+  dijkstra(adjacency, source, distances, queue, Single_target{destination},
+           paths);
+  // Check if a path from source to destination exists
+  if (distances.get(destination) == distances.unreached) {
+    return -1;
+  }
+  std::vector<int> path = paths.path_to(destination, distances);
+  // printing stays out of the measured time
+  steady_clock::time_point end = steady_clock::now();
+
+  if (print_paths && V <= 10 && number_of_tests == 1) {
+    printf(
+        "\nPath and distance from source vertex %d to destination vertex %d:\n",
+        source, destination);
+    printf("Distance = %d, Path: ", distances.get(destination));
+    for (int vertex : path) {
+      printf("%d -> ", vertex);
+    }
+    printf("and back\n");
+  }
+
+  return duration<double, std::micro>(end - begin).count();
+}
+
+// fraction of all possible edges, the inverse of calculate_edges
+static float edge_density(int vertices, size_t edges) {
+  if (vertices < 2) {
+    return 0;
+  }
+  return 2.0 * edges / ((double)vertices * (vertices - 1));
 }
 
 /*
@@ -52,184 +221,179 @@ void Graph::print_measures_mean() {
 
 */
 
-List_graph::List_graph(int vertices, float density_percent)
-    : Graph(vertices, density_percent) {
+List_graph::List_graph(int vertices, float density_percent, long long seed)
+    : Graph(vertices, density_percent, seed) {
+  // 1, 2, 4, ... threads up to all hardware threads
+  int hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (int threads = 1; threads < hardware_threads; threads *= 2) {
+    parallel_threads.push_back(threads);
+  }
+  parallel_threads.push_back(hardware_threads);
+  time_for_delta.resize(parallel_threads.size(), 0);
+  batch_throughput.resize(parallel_threads.size(), 0);
 
-  int edge_number = calculate_edges();
   for (int test = 0; test < number_of_tests; test++) {
+    // the graph of the last test stays, freed by the destructor
+    delete[] adj;
     adj = new std::list<int_pair>[V];
     // graph initialization
     // std::cout << "\nStarted test no. " << test + 1 << std::endl;
 
-    for (int i = 0; i < edge_number; i++) {
-      int first_vertex = value_gen('v', V); // choosing random vertex
-      int weight = value_gen('w');          // and weight
-      int second_vertex = value_gen('v', V);
-      while (first_vertex == second_vertex) {
-        second_vertex = value_gen('v', V);
-      }
-
-      // for avoiding double edges to same vertices
-      bool doubled_edge = false;
-      for (auto elem : adj[first_vertex]) {
-        if (elem.first == second_vertex) {
-          doubled_edge = true;
-          break;
-        }
-      }
-      if (doubled_edge) {
-        i--;
-        continue;
-      }
-      insert_edge(first_vertex, second_vertex, weight);
+    for (const Edge &edge : generate_edges(test)) {
+      insert_edge(edge.first_vertex, edge.second_vertex, edge.weight);
     }
 
     // measurements
-    time_for_all += dijkstra_to_others(value_gen('v', V));
+    int source = value_gen('v', V);
+    time_for_all += dijkstra_to_others(source);
+    measure_delta_stepping(source);
+    measure_batch_queries(source);
     double t_t_t = dijkstra_to_chosen(value_gen('v', V), value_gen('v', V));
     while (t_t_t == -1) {
       // std::cout << t_t_t << " ";
       t_t_t = dijkstra_to_chosen(value_gen('v', V), value_gen('v', V));
     }
     time_for_two += t_t_t;
-
-    delete[] adj;
+    // changes the graph, so it goes last
+    measure_spt_cache();
   }
 
   std::cout << "\n\tList graph\t|V| = " << V << "\tD = " << density_percent
             << "\n";
   print_measures_mean();
+  print_parallel_measures();
 }
 
+List_graph::List_graph(int vertices, const std::vector<Edge> &edges)
+    : Graph(vertices, edge_density(vertices, edges.size()), 0) {
+  print_paths = false;
+  adj = new std::list<int_pair>[V];
+  for (const Edge &edge : edges) {
+    insert_edge(edge.first_vertex, edge.second_vertex, edge.weight);
+  }
+}
+
+List_graph::~List_graph() { delete[] adj; }
+
 void List_graph::insert_edge(int first_vertex, int second_vertex, int weight) {
   adj[first_vertex].emplace_back(second_vertex, weight);
   adj[second_vertex].emplace_back(first_vertex, weight);
 }
 
-int List_graph::dijkstra_to_others(int source) {
-  // std::cout << "  hello from dto " << V << " " << density_percent << "\n";
-  steady_clock::time_point begin = steady_clock::now();
-  std::priority_queue<int_pair, std::vector<int_pair>, std::greater<int_pair>>
-      pq;
-  std::vector<int> distances(V, 999);
-  std::vector<int> parents(
-      V, -1); // To store the parent of each vertex in the shortest path tree
-  pq.emplace(0, source);
-  distances[source] = 0;
-
-  while (!pq.empty()) {
-    int min_distance_vertex = pq.top().second;
-    pq.pop();
-    for (auto &elem : adj[min_distance_vertex]) {
-      int vertex = elem.first;
-      int weight = elem.second;
-
-      int next_check = distances[min_distance_vertex] + weight;
-      if (distances[vertex] > next_check) {
-        distances[vertex] = next_check;
-        parents[vertex] =
-            min_distance_vertex; // Update the parent of the vertex
-        pq.emplace(distances[vertex], vertex);
-      }
+void List_graph::update_edge(int first_vertex, int second_vertex, int weight) {
+  for (auto &elem : adj[first_vertex]) {
+    if (elem.first == second_vertex) {
+      elem.second = weight;
     }
   }
-
-  if (V <= 10 && number_of_tests == 1) {
-    printf(
-        "\nPaths and distances from source vertex %d to all other vertices:\n",
-        source);
-    for (int i = 0; i < V; ++i) {
-      if (i != source) {
-        int distance = distances[i];
-        std::vector<int> path;
-        int curr = i;
-        while (curr != -1) {
-          path.push_back(curr);
-          curr = parents[curr];
-        }
-        std::reverse(path.begin(), path.end());
-        printf("Vertex %d: Distance = %d, Path: ", i, distance);
-        for (int vertex : path) {
-          printf("%d -> ", vertex);
-        }
-        printf("and back\n");
-      }
+  for (auto &elem : adj[second_vertex]) {
+    if (elem.first == first_vertex) {
+      elem.second = weight;
     }
   }
-
-  steady_clock::time_point end = steady_clock::now();
-  return duration_cast<microseconds>(end - begin).count();
 }
 
-int List_graph::dijkstra_to_chosen(int source, int destination) {
-  // std::cout << "  hello from dtc " << V << " " << density_percent << "\n";
+void List_graph::remove_edge(int first_vertex, int second_vertex) {
+  adj[first_vertex].remove_if(
+      [&](const int_pair &elem) { return elem.first == second_vertex; });
+  adj[second_vertex].remove_if(
+      [&](const int_pair &elem) { return elem.first == first_vertex; });
+}
 
-  // ensuring that different vertices were chosen
-  while (destination == source) {
-    source = value_gen('v', V);
+int List_graph::edge_weight(int first_vertex, int second_vertex) const {
+  for (auto &elem : adj[first_vertex]) {
+    if (elem.first == second_vertex) {
+      return elem.second;
+    }
   }
+  return 0;
+}
 
-  steady_clock::time_point begin = steady_clock::now();
-  std::priority_queue<int_pair, std::vector<int_pair>, std::greater<int_pair>>
-      pq;
-  std::vector<int> distances(V, 999);
-  std::vector<int> parents(
-      V, -1); // To store the parent of each vertex in the shortest path tree
-  pq.emplace(0, source);
-  distances[source] = 0;
-
-  while (!pq.empty()) {
-    int min_distance_vertex = pq.top().second;
-    pq.pop();
-
-    if (min_distance_vertex == destination) {
-      break;
-    }
+void List_graph::neighbours(int vertex, std::vector<int_pair> &out) const {
+  out.assign(adj[vertex].begin(), adj[vertex].end());
+}
 
-    for (auto &elem : adj[min_distance_vertex]) {
-      int vertex = elem.first;
-      int weight = elem.second;
+double List_graph::dijkstra_to_others(int source) {
+  return timed_dijkstra_to_others(List_adjacency{adj}, source);
+}
+
+void List_graph::measure_delta_stepping(int source) {
+  Csr_graph csr(V, adj);
+  int delta = auto_delta(csr);
+
+  for (size_t step = 0; step < parallel_threads.size(); step++) {
+    Thread_pool pool(parallel_threads[step]);
+    steady_clock::time_point begin = steady_clock::now();
+    Sssp_result result = delta_stepping(csr, source, delta, pool);
+    steady_clock::time_point end = steady_clock::now();
+    time_for_delta[step] += duration<double, std::micro>(end - begin).count();
 
-      int next_check = distances[min_distance_vertex] + weight;
-      if (distances[vertex] > next_check) {
-        distances[vertex] = next_check;
-        parents[vertex] =
-            min_distance_vertex; // Update the parent of the vertex
-        pq.emplace(distances[vertex], vertex);
+    bool differs = false;
+    for (int vertex = 0; vertex < V; vertex++) {
+      if (!matches_last_search(vertex, result.distances[vertex],
+                               result.parents[vertex])) {
+        differs = true;
       }
     }
+    if (differs) {
+      std::cout << "Delta-stepping with " << parallel_threads[step]
+                << " threads differs from Dijkstra for source " << source
+                << "\n";
+    }
   }
+}
 
-  // Check if a path from source to destination exists
-  if (distances[destination] == 999) {
-    // printf("\nNo path exists from source vertex %d to destination vertex
-    // %d\n",
-    //        source, destination);
-    return -1;
+void List_graph::measure_batch_queries(int source) {
+  const int batch_size = 256;
+  Csr_graph csr(V, adj);
+  std::vector<int_pair> pairs;
+  for (int query = 0; query < batch_size; query++) {
+    pairs.emplace_back(value_gen('v', V), value_gen('v', V));
   }
 
-  int distance = distances[destination];
-  std::vector<int> path;
-  int curr = destination;
-  while (curr != -1) {
-    path.push_back(curr);
-    curr = parents[curr];
+  for (size_t step = 0; step < parallel_threads.size(); step++) {
+    Batch_solver solver(csr, parallel_threads[step]);
+    steady_clock::time_point begin = steady_clock::now();
+    solver.solve_pairs(pairs);
+    steady_clock::time_point end = steady_clock::now();
+    double seconds = duration<double>(end - begin).count();
+    batch_throughput[step] += batch_size / seconds;
+
+    // the same workspaces answer one-to-all queries like dijkstra_to_others
+    bool differs = false;
+    solver.solve_sources({source}, [&](int, const Dijkstra_workspace &ws) {
+      for (int vertex = 0; vertex < V; vertex++) {
+        if (!matches_last_search(vertex, ws.distance(vertex),
+                                 ws.parent(vertex))) {
+          differs = true;
+        }
+      }
+    });
+    if (differs) {
+      std::cout << "Batched Dijkstra with " << parallel_threads[step]
+                << " threads differs from Dijkstra for source " << source
+                << "\n";
+    }
   }
-  if (V <= 10 && number_of_tests == 1) {
-    std::reverse(path.begin(), path.end());
+}
 
-    printf(
-        "\nPath and distance from source vertex %d to destination vertex %d:\n",
-        source, destination);
-    printf("Distance = %d, Path: ", distance);
-    for (int vertex : path) {
-      printf("%d -> ", vertex);
-    }
-    printf("and back\n");
+void List_graph::print_parallel_measures() {
+  for (size_t step = 0; step < parallel_threads.size(); step++) {
+    std::cout << "Delta-stepping from source to all of the vertices with "
+              << parallel_threads[step]
+              << " threads took: " << arithmetic_mean(time_for_delta[step])
+              << " us\n";
   }
+  for (size_t step = 0; step < parallel_threads.size(); step++) {
+    std::cout << "Batched queries between two vertices with "
+              << parallel_threads[step]
+              << " threads: " << arithmetic_mean(batch_throughput[step])
+              << " queries/s\n";
+  }
+}
 
-  steady_clock::time_point end = steady_clock::now();
-  return duration_cast<microseconds>(end - begin).count();
+double List_graph::dijkstra_to_chosen(int source, int destination) {
+  return timed_dijkstra_to_chosen(List_adjacency{adj}, source, destination);
 }
 
 /*
@@ -238,47 +402,50 @@ int List_graph::dijkstra_to_chosen(int source, int destination) {
  GRAPH UTILITIES
 
 */
-Matrix_graph::Matrix_graph(int vertices, float density_percent)
-    : Graph(vertices, density_percent) {
-  int edge_number = calculate_edges();
+Matrix_graph::Matrix_graph(int vertices, float density_percent,
+                           long long seed)
+    : Graph(vertices, density_percent, seed) {
   adj.resize(V, std::vector<int>(V, 0));
 
   for (int test = 0; test < number_of_tests; test++) {
-    // graph initialization
+    // graph initialization, the graph of the last test stays
     // std::cout << "\nStarted test no. " << test + 1 << std::endl;
+    for (auto &row : adj) {
+      std::fill(row.begin(), row.end(), 0);
+    }
 
-    for (int i = 0; i < edge_number; i++) {
-      int first_vertex = value_gen('v', V); // choosing random vertex
-      int weight = value_gen('w');          // and weight
-      int second_vertex = value_gen('v', V);
-      while (first_vertex == second_vertex) {
-        second_vertex = value_gen('v', V);
-      }
-
-      // for avoiding double edges to same vertices
-      if (adj[first_vertex][second_vertex] != 0) {
-        i--;
-        continue;
-      }
-      insert_edge(first_vertex, second_vertex, weight);
+    for (const Edge &edge : generate_edges(test)) {
+      insert_edge(edge.first_vertex, edge.second_vertex, edge.weight);
     }
 
     // measurements
-    time_for_all += dijkstra_to_others(value_gen('v', V));
+    int source = value_gen('v', V);
+    time_for_all += dijkstra_to_others(source);
     double t_t_t = dijkstra_to_chosen(value_gen('v', V), value_gen('v', V));
     while (t_t_t == -1) {
       t_t_t = dijkstra_to_chosen(value_gen('v', V), value_gen('v', V));
     }
     time_for_two += t_t_t;
-
-    for (auto &row : adj) {
-      std::fill(row.begin(), row.end(), 0);
-    }
+    measure_packed(source, value_gen('v', V));
+    measure_all_pairs();
+    // changes the graph, so it goes last
+    measure_spt_cache();
   }
 
   std::cout << "\n\tMatrix graph\t|V| = " << V << "\tD = " << density_percent
             << "\n";
   print_measures_mean();
+  print_packed_measures();
+  print_all_pairs_measures();
+}
+
+Matrix_graph::Matrix_graph(int vertices, const std::vector<Edge> &edges)
+    : Graph(vertices, edge_density(vertices, edges.size()), 0) {
+  print_paths = false;
+  adj.resize(V, std::vector<int>(V, 0));
+  for (const Edge &edge : edges) {
+    insert_edge(edge.first_vertex, edge.second_vertex, edge.weight);
+  }
 }
 
 void Matrix_graph::insert_edge(int first_vertex, int second_vertex,
@@ -287,141 +454,103 @@ void Matrix_graph::insert_edge(int first_vertex, int second_vertex,
   adj[second_vertex][first_vertex] = weight;
 }
 
-int Matrix_graph::dijkstra_to_others(int source) {
-  // std::cout << "  hello from dto " << V << " " << density_percent << "\n";
-  steady_clock::time_point begin = steady_clock::now();
-  std::priority_queue<int_pair, std::vector<int_pair>, std::greater<int_pair>>
-      pq;
-  std::vector<int> distances(V, 999);
-  std::vector<int> parents(
-      V, -1); // To store the parent of each vertex in the shortest path tree
-
-  pq.emplace(0, source);
-  distances[source] = 0;
-
-  while (!pq.empty()) {
-    int min_distance_vertex = pq.top().second;
-    pq.pop();
-
-    // Access the adjacency matrix to get neighboring vertices and weights
-    for (int vertex = 0; vertex < V; vertex++) {
-      int weight = adj[min_distance_vertex][vertex];
+void Matrix_graph::update_edge(int first_vertex, int second_vertex,
+                               int weight) {
+  insert_edge(first_vertex, second_vertex, weight);
+}
 
-      // Skip if there is no edge or the vertex has already been processed
-      if (weight == 0 || distances[vertex] != 999) {
-        continue;
-      }
+void Matrix_graph::remove_edge(int first_vertex, int second_vertex) {
+  insert_edge(first_vertex, second_vertex, 0);
+}
 
-      int next_check = distances[min_distance_vertex] + weight;
-      if (distances[vertex] > next_check) {
-        distances[vertex] = next_check;
-        parents[vertex] =
-            min_distance_vertex; // Update the parent of the vertex
-        pq.emplace(distances[vertex], vertex);
-      }
-    }
-  }
+int Matrix_graph::edge_weight(int first_vertex, int second_vertex) const {
+  return adj[first_vertex][second_vertex];
+}
 
-  if (V <= 10 && number_of_tests == 1) {
-    printf(
-        "\nPaths and distances from source vertex %d to all other vertices:\n",
-        source);
-    for (int i = 0; i < V; ++i) {
-      if (i != source) {
-        int distance = distances[i];
-        std::vector<int> path;
-        int curr = i;
-        while (curr != -1) {
-          path.push_back(curr);
-          curr = parents[curr];
-        }
-        std::reverse(path.begin(), path.end());
-        printf("Vertex %d: Distance = %d, Path: ", i, distance);
-        for (int vertex : path) {
-          printf("%d -> ", vertex);
-        }
-        printf("and back\n");
-      }
+void Matrix_graph::neighbours(int vertex, std::vector<int_pair> &out) const {
+  out.clear();
+  for (int neighbour = 0; neighbour < V; neighbour++) {
+    if (adj[vertex][neighbour] != 0) {
+      out.emplace_back(neighbour, adj[vertex][neighbour]);
     }
   }
+}
 
-  steady_clock::time_point end = steady_clock::now();
-  return duration_cast<microseconds>(end - begin).count();
+double Matrix_graph::dijkstra_to_others(int source) {
+  return timed_dijkstra_to_others(Matrix_adjacency{&adj}, source);
 }
 
-int Matrix_graph::dijkstra_to_chosen(int source, int destination) {
-  // std::cout << "  hello from dtc " << V << " " << density_percent << "\n";
-  // ensuring that different vertices were chosen
-  while (destination == source) {
-    source = value_gen('v', V);
-  }
+void Matrix_graph::measure_packed(int source, int destination) {
+  Packed_matrix_graph packed(adj);
 
   steady_clock::time_point begin = steady_clock::now();
-  std::priority_queue<int_pair, std::vector<int_pair>, std::greater<int_pair>>
-      pq;
-  std::vector<int> distances(V, 999);
-  std::vector<int> parents(
-      V, -1); // To store the parent of each vertex in the shortest path tree
-
-  pq.emplace(0, source);
-  distances[source] = 0;
-
-  while (!pq.empty()) {
-    int min_distance_vertex = pq.top().second;
-    pq.pop();
-
-    // Stop the algorithm if the destination vertex is found
-    if (min_distance_vertex == destination) {
-      break;
-    }
+  packed.dijkstra_to_others(source);
+  steady_clock::time_point end = steady_clock::now();
+  time_for_packed_all += duration<double, std::micro>(end - begin).count();
 
-    // Access the adjacency matrix to get neighboring vertices and weights
-    for (int vertex = 0; vertex < V; vertex++) {
-      int weight = adj[min_distance_vertex][vertex];
+  begin = steady_clock::now();
+  packed.dijkstra_to_chosen(source, destination);
+  end = steady_clock::now();
+  time_for_packed_two += duration<double, std::micro>(end - begin).count();
+}
 
-      // Skip if there is no edge or the vertex has already been processed
-      if (weight == 0 || distances[vertex] != 999) {
-        continue;
-      }
+void Matrix_graph::print_packed_measures() {
+  std::cout << "Matrix memory: " << nested_matrix_bytes(V)
+            << " B nested vectors, " << packed_matrix_bytes(V)
+            << " B packed with presence bits\n";
+  std::cout << "Calculating the shortest path from source to all of the "
+               "vertices in the packed matrix took: "
+            << arithmetic_mean(time_for_packed_all) << " us\n";
+  std::cout << "Calculating the shortest path from source to one of the "
+               "vertices in the packed matrix took: "
+            << arithmetic_mean(time_for_packed_two) << " us\n";
+}
 
-      int next_check = distances[min_distance_vertex] + weight;
-      if (distances[vertex] > next_check) {
-        distances[vertex] = next_check;
-        parents[vertex] =
-            min_distance_vertex; // Update the parent of the vertex
-        pq.emplace(distances[vertex], vertex);
-      }
-    }
+void Matrix_graph::measure_all_pairs() {
+  // O(V^3) either way, far too slow for the biggest matrices
+  if (V > all_pairs_limit) {
+    return;
   }
+  Thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+  steady_clock::time_point begin = steady_clock::now();
+  Distance_matrix matrix = initial_distances(adj);
+  floyd_warshall(matrix, pool);
+  steady_clock::time_point end = steady_clock::now();
+  time_for_all_pairs += duration<double, std::micro>(end - begin).count();
 
-  // Check if a path from source to destination exists
-  if (distances[destination] == 999) {
-    // printf("\nNo path exists from source vertex %d to destination vertex
-    // %d\n",
-    //        source, destination);
-    return -1;
+  // small graphs print every path, see dijkstra_to_others
+  if (V <= 10) {
+    return;
   }
-
-  int distance = distances[destination];
-  std::vector<int> path;
-  int curr = destination;
-  while (curr != -1) {
-    path.push_back(curr);
-    curr = parents[curr];
+  begin = steady_clock::now();
+  for (int source = 0; source < V; source++) {
+    dijkstra_to_others(source);
   }
-  if (V <= 10 && number_of_tests == 1) {
-    std::reverse(path.begin(), path.end());
+  end = steady_clock::now();
+  time_for_repeated += duration<double, std::micro>(end - begin).count();
+}
 
-    printf(
-        "\nPath and distance from source vertex %d to destination vertex %d:\n",
-        source, destination);
-    printf("Distance = %d, Path: ", distance);
-    for (int vertex : path) {
-      printf("%d -> ", vertex);
-    }
-    printf("and back\n");
+void Matrix_graph::print_all_pairs_measures() {
+  if (V > all_pairs_limit) {
+    return;
   }
+  // one addition and one comparison per (i, k, j) triple
+  double operations = 2.0 * V * V * V;
+  double all_pairs = arithmetic_mean(time_for_all_pairs);
+  std::cout << "Calculating the shortest paths between all of the vertices "
+               "with blocked Floyd-Warshall ("
+            << (floyd_warshall_uses_avx2() ? "AVX2" : "scalar")
+            << ") took: " << all_pairs << " us, "
+            << operations / all_pairs / 1000 << " GFLOP/s\n";
+  if (V > 10) {
+    double repeated = arithmetic_mean(time_for_repeated);
+    std::cout << "Calculating the shortest paths between all of the vertices "
+                 "with dijkstra_to_others from every vertex took: "
+              << repeated << " us, " << operations / repeated / 1000
+              << " GFLOP/s equivalent\n";
+  }
+}
 
-  steady_clock::time_point end = steady_clock::now();
-  return duration_cast<microseconds>(end - begin).count();
+double Matrix_graph::dijkstra_to_chosen(int source, int destination) {
+  return timed_dijkstra_to_chosen(Matrix_adjacency{&adj}, source, destination);
 }
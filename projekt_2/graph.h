@@ -1,3 +1,9 @@
+#pragma once
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "graph_generator.h"
 #include <list>
 #include <vector>
 
@@ -7,40 +13,119 @@ class Graph {
 protected:
   int V; // no. of vertices
   int number_of_tests = 1;
+  bool print_paths = true; // paths of graphs with |V| <= 10
   float density_percent;
-  double time_for_all = 0, time_for_two = 0;
+  unsigned long long seed; // of the generated graphs and chosen vertices
+  double time_for_all = 0, time_for_two = 0, time_for_generation = 0;
+  double time_for_repair = 0, time_for_recompute = 0;
+
+  // results of the latest dijkstra_to_others, kept for cross-checking other
+  // shortest path algorithms
+  std::vector<int> last_distances, last_parents;
+  // whether an exact distance and parent of vertex, unreached_distance when
+  // it is unreachable, agree with the latest dijkstra_to_others, which never
+  // relaxes a vertex to experiment_unreached (dijkstra.h) or more
+  bool matches_last_search(int vertex, int distance, int parent) const;
 
-  int calculate_edges() { return (density_percent * (V * (V - 1))) / 2; }
+  // computed in double, V * (V - 1) overflows int for V above ~46k
+  int calculate_edges() { return density_percent * ((double)V * (V - 1)) / 2; }
   int value_gen(char type, int vertices_number = 0);
+  std::vector<Edge> generate_edges(int test);
   double arithmetic_mean(double value) { return value / number_of_tests; }
   void print_measures_mean();
+  void measure_spt_cache();
+
+  // bodies of the dijkstra overrides, timed and printed the same way for
+  // every adjacency policy of dijkstra.h
+  template <class Adjacency>
+  double timed_dijkstra_to_others(const Adjacency &adjacency, int source);
+  template <class Adjacency>
+  double timed_dijkstra_to_chosen(const Adjacency &adjacency, int source,
+                                  int destination);
+
+  Graph(int vertices, float density_percent, long long seed);
 
-  Graph(int vertices, float density_percent)
-      : V(vertices), density_percent(density_percent) {};
+public:
+  virtual ~Graph() = default;
+  int vertices() const { return V; }
+
+  // both return the elapsed time in microseconds, dijkstra_to_chosen -1 when
+  // there is no path
+  virtual double dijkstra_to_others(int source) = 0;
+  virtual double dijkstra_to_chosen(int source, int destination) = 0;
+  // distances and parents of the latest dijkstra_to_others,
+  // experiment_unreached and -1 for vertices it did not reach below it
+  const std::vector<int> &latest_distances() const { return last_distances; }
+  const std::vector<int> &latest_parents() const { return last_parents; }
+
+  // edge updates, all of them keep the graph undirected; insert_edge expects
+  // the edge to be missing, update_edge and remove_edge to exist
   virtual void insert_edge(int first_vertex, int second_vertex, int weight) = 0;
+  virtual void update_edge(int first_vertex, int second_vertex, int weight) = 0;
+  virtual void remove_edge(int first_vertex, int second_vertex) = 0;
 
-  virtual int dijkstra_to_others(int source) = 0;
-  virtual int dijkstra_to_chosen(int source, int destination) = 0;
+  // weight of the edge, 0 when there is none
+  virtual int edge_weight(int first_vertex, int second_vertex) const = 0;
+  // replaces `out` with (vertex, weight) of every neighbour
+  virtual void neighbours(int vertex, std::vector<int_pair> &out) const = 0;
 };
 
-class List_graph : public Graph {
-  std::list<int_pair> *adj; // vertex and weight of every edge
-  void insert_edge(int first_vertex, int second_vertex, int weight) override;
+// final, so calls made through the concrete type are resolved at compile time
+class List_graph final : public Graph {
+  std::list<int_pair> *adj = nullptr; // vertex and weight of every edge
+  std::vector<int> parallel_threads; // thread counts of parallel measures
+  std::vector<double> time_for_delta; // one sum per entry of parallel_threads
+  std::vector<double> batch_throughput; // queries/s, per parallel_threads
 
-  int dijkstra_to_others(int source) override;
-  int dijkstra_to_chosen(int source, int destination) override;
+  void measure_delta_stepping(int source);
+  void measure_batch_queries(int source);
+  void print_parallel_measures();
 
 public:
-  List_graph(int vertices, float density_percent);
+  // seed -1 draws a random seed, any other value makes the run reproducible;
+  // the graph of the last test stays, the edge updates work on it afterwards
+  List_graph(int vertices, float density_percent, long long seed = -1);
+  // only builds the graph, without measurements or printed paths
+  List_graph(int vertices, const std::vector<Edge> &edges);
+  ~List_graph();
+  List_graph(const List_graph &) = delete;
+  List_graph &operator=(const List_graph &) = delete;
+
+  double dijkstra_to_others(int source) override;
+  double dijkstra_to_chosen(int source, int destination) override;
+
+  void insert_edge(int first_vertex, int second_vertex, int weight) override;
+  void update_edge(int first_vertex, int second_vertex, int weight) override;
+  void remove_edge(int first_vertex, int second_vertex) override;
+  int edge_weight(int first_vertex, int second_vertex) const override;
+  void neighbours(int vertex, std::vector<int_pair> &out) const override;
 };
 
-class Matrix_graph : public Graph {
+class Matrix_graph final : public Graph {
   std::vector<std::vector<int>> adj;
-  void insert_edge(int first_vertex, int second_vertex, int weight) override;
+  static const int all_pairs_limit = 2000; // largest |V| for all pairs runs
+  double time_for_all_pairs = 0, time_for_repeated = 0;
+  double time_for_packed_all = 0, time_for_packed_two = 0;
 
-  int dijkstra_to_others(int source) override;
-  int dijkstra_to_chosen(int source, int destination) override;
+  void measure_all_pairs();
+  void print_all_pairs_measures();
+  void measure_packed(int source, int destination);
+  void print_packed_measures();
 
 public:
-  Matrix_graph(int vertices, float density_percent);
+  // like List_graph's, the graph of the last test stays
+  Matrix_graph(int vertices, float density_percent, long long seed = -1);
+  // only builds the graph, without measurements or printed paths
+  Matrix_graph(int vertices, const std::vector<Edge> &edges);
+
+  double dijkstra_to_others(int source) override;
+  double dijkstra_to_chosen(int source, int destination) override;
+
+  void insert_edge(int first_vertex, int second_vertex, int weight) override;
+  void update_edge(int first_vertex, int second_vertex, int weight) override;
+  void remove_edge(int first_vertex, int second_vertex) override;
+  int edge_weight(int first_vertex, int second_vertex) const override;
+  void neighbours(int vertex, std::vector<int_pair> &out) const override;
 };
+
+#endif // !GRAPH_H
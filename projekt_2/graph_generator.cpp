@@ -0,0 +1,185 @@
+#include "graph_generator.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_set>
+
+namespace {
+
+unsigned long long splitmix64(unsigned long long x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// counter based generator, independent streams need no shared state
+unsigned long long random_bits(unsigned long long seed,
+                               unsigned long long stream,
+                               unsigned long long counter) {
+  return splitmix64(splitmix64(seed ^ splitmix64(stream)) + counter);
+}
+
+// uniform in (0, 1]
+double random_unit(unsigned long long bits) {
+  return ((bits >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// uniform in [0, range)
+unsigned long long random_below(unsigned long long bits,
+                                unsigned long long range) {
+  return (unsigned long long)(((unsigned __int128)bits * range) >> 64);
+}
+
+const unsigned long long weight_stream = 1ULL << 62;
+const unsigned long long drop_stream = (1ULL << 62) + 1;
+
+// number of possible edges before row `first`
+long long row_start(int V, long long first) {
+  return first * (2LL * V - first - 1) / 2;
+}
+
+Edge decode_edge(int V, long long index) {
+  double b = 2.0 * V - 1;
+  long long first = (b - std::sqrt(b * b - 8.0 * index)) / 2;
+  first = std::max(0LL, std::min(first, (long long)V - 2));
+  // correct rounding errors of the square root
+  while (first > 0 && row_start(V, first) > index) {
+    first--;
+  }
+  while (first + 1 < V - 1 && row_start(V, first + 1) <= index) {
+    first++;
+  }
+  Edge edge;
+  edge.first_vertex = first;
+  edge.second_vertex = first + 1 + (index - row_start(V, first));
+  return edge;
+}
+
+} // namespace
+
+Graph_generator::Graph_generator(int vertices, long long edges,
+                                 unsigned long long seed, int threads)
+    : V(vertices), edge_count(edges), seed(seed),
+      threads(std::max(1, threads)) {}
+
+std::vector<Edge> Graph_generator::generate() const {
+  const long long possible = V < 2 ? 0 : (long long)V * (V - 1) / 2;
+  const long long wanted = std::min(std::max(0LL, edge_count), possible);
+  if (wanted == 0) {
+    return {};
+  }
+
+  // the chunking depends on the graph only, never on the thread count
+  const long long chunks =
+      std::max(1LL, std::min(4096LL, possible / (1LL << 16)));
+  std::vector<std::vector<long long>> sampled(chunks);
+  Thread_pool pool(threads);
+
+  // Bernoulli sampling with a slightly raised probability gives at least
+  // `wanted` indices in all but rare cases, which just retry a bit higher
+  double probability = (wanted + 4 * std::sqrt((double)wanted) + 16) / possible;
+  long long total = 0;
+  for (unsigned long long attempt = 0; total < wanted; attempt++) {
+    double chunk_probability = std::min(1.0, probability);
+    pool.parallel_for(chunks, [&](long long begin, long long end, int) {
+      for (long long chunk = begin; chunk < end; chunk++) {
+        long long first_index = possible * chunk / chunks;
+        long long last_index = possible * (chunk + 1) / chunks;
+        std::vector<long long> &indices = sampled[chunk];
+        indices.clear();
+        if (chunk_probability >= 1) {
+          for (long long index = first_index; index < last_index; index++) {
+            indices.push_back(index);
+          }
+          continue;
+        }
+        // geometric gaps between chosen indices
+        unsigned long long stream = (attempt << 32) | chunk;
+        double log_miss = std::log1p(-chunk_probability);
+        long long index = first_index - 1;
+        for (unsigned long long counter = 0;; counter++) {
+          double gap = std::floor(
+              std::log(random_unit(random_bits(seed, stream, counter))) /
+              log_miss);
+          if (gap >= last_index - index - 1) {
+            break;
+          }
+          index += 1 + (long long)gap;
+          indices.push_back(index);
+        }
+      }
+    });
+
+    total = 0;
+    for (auto &indices : sampled) {
+      total += indices.size();
+    }
+    probability *= 1.1;
+  }
+
+  // drop a uniform subset of the surplus (Floyd's algorithm), what is left
+  // is a uniform subset of exactly `wanted` indices
+  long long surplus = total - wanted;
+  std::unordered_set<long long> dropped;
+  for (long long j = total - surplus; j < total; j++) {
+    long long position =
+        random_below(random_bits(seed, drop_stream, j), j + 1);
+    if (!dropped.insert(position).second) {
+      dropped.insert(j);
+    }
+  }
+
+  std::vector<long long> drops(dropped.begin(), dropped.end());
+  std::sort(drops.begin(), drops.end());
+
+  // positions in the concatenation of all chunks
+  std::vector<long long> chunk_offset(chunks + 1, 0);
+  for (long long chunk = 0; chunk < chunks; chunk++) {
+    chunk_offset[chunk + 1] = chunk_offset[chunk] + sampled[chunk].size();
+  }
+  auto drops_before = [&](long long position) {
+    return std::lower_bound(drops.begin(), drops.end(), position) -
+           drops.begin();
+  };
+
+  std::vector<Edge> edges(wanted);
+  pool.parallel_for(chunks, [&](long long begin, long long end, int) {
+    for (long long chunk = begin; chunk < end; chunk++) {
+      long long next_drop = drops_before(chunk_offset[chunk]);
+      long long out = chunk_offset[chunk] - next_drop;
+      for (size_t i = 0; i < sampled[chunk].size(); i++) {
+        if (next_drop < (long long)drops.size() &&
+            drops[next_drop] == chunk_offset[chunk] + (long long)i) {
+          next_drop++;
+          continue;
+        }
+        long long index = sampled[chunk][i];
+        Edge edge = decode_edge(V, index);
+        edge.weight =
+            1 + random_below(random_bits(seed, weight_stream, index), 20);
+        edges[out++] = edge;
+      }
+    }
+  });
+  return edges;
+}
+
+bool Graph_generator::write(const std::string &path) const {
+  return write_edge_list(path, V, generate());
+}
+
+bool write_edge_list(const std::string &path, int vertices,
+                     const std::vector<Edge> &edges) {
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fprintf(file, "# vertices %d edges %zu\n", vertices, edges.size());
+  for (const Edge &edge : edges) {
+    std::fprintf(file, "%d %d %d\n", edge.first_vertex, edge.second_vertex,
+                 edge.weight);
+  }
+  return std::fclose(file) == 0;
+}
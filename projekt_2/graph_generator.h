@@ -0,0 +1,43 @@
+#pragma once
+
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include <string>
+#include <vector>
+
+struct Edge {
+  int first_vertex;
+  int second_vertex;
+  int weight;
+};
+
+// Random undirected graphs with exactly the requested number of distinct
+// edges and weights 1..20. Every one of the V * (V - 1) / 2 possible edges has
+// an index, the generator draws a uniform subset of indices without
+// rejection and decodes them into vertex pairs. Random numbers come from a
+// counter based generator keyed by (seed, stream, counter), so the index range
+// is split into chunks that are sampled in parallel and the same seed gives
+// the same graph for any number of threads.
+class Graph_generator {
+  int V;
+  long long edge_count;
+  unsigned long long seed;
+  int threads;
+
+public:
+  Graph_generator(int vertices, long long edges, unsigned long long seed,
+                  int threads = 1);
+
+  // edges ordered by (first_vertex, second_vertex), first < second
+  std::vector<Edge> generate() const;
+
+  // "# vertices V edges E" followed by one "first second weight" line per
+  // edge, returns false when the file cannot be written
+  bool write(const std::string &path) const;
+};
+
+bool write_edge_list(const std::string &path, int vertices,
+                     const std::vector<Edge> &edges);
+
+#endif // !GRAPH_GENERATOR_H
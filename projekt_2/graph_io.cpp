@@ -0,0 +1,567 @@
+#include "graph_io.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char binary_graph_magic[8] = {'P', 'I', 'A', 'A', 'G', 'R', 'P', 'H'};
+const char compressed_graph_magic[8] = {'P', 'I', 'A', 'A',
+                                        'C', 'G', 'R', 'F'};
+const unsigned native_byte_order = 0x01020304;
+const long long page = 4096;
+
+long long page_align(long long position) {
+  return (position + page - 1) / page * page;
+}
+
+bool read_file(const std::string &path, std::vector<char> &contents) {
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  long size = std::ftell(file);
+  std::fseek(file, 0, SEEK_SET);
+  contents.resize(size + 1);
+  bool complete = std::fread(contents.data(), 1, size, file) == (size_t)size;
+  contents[size] = '\0';
+  std::fclose(file);
+  return complete;
+}
+
+// hand written number parsing, the text readers spend their time here
+class Line_parser {
+  static constexpr long long max_number = 1000000000000000LL;
+  const char *position;
+
+public:
+  explicit Line_parser(const char *line) : position(line) {}
+
+  void skip_blanks() {
+    while (*position == ' ' || *position == '\t' || *position == '\r') {
+      position++;
+    }
+  }
+
+  bool at_end() {
+    skip_blanks();
+    return *position == '\0';
+  }
+
+  bool number(long long &value) {
+    skip_blanks();
+    bool negative = *position == '-';
+    position += negative;
+    if (*position < '0' || *position > '9') {
+      return false;
+    }
+    value = 0;
+    while (*position >= '0' && *position <= '9') {
+      // saturated, far beyond anything the readers accept
+      value = std::min(value * 10 + (*position++ - '0'), max_number);
+    }
+    value = negative ? -value : value;
+    return true;
+  }
+
+  bool word(const char *expected) {
+    skip_blanks();
+    size_t length = std::strlen(expected);
+    if (std::strncmp(position, expected, length) != 0) {
+      return false;
+    }
+    position += length;
+    return true;
+  }
+};
+
+// calls parse_line(line, problem) for every line and stops at the first
+// false, reporting "path:line: problem" on stderr
+template <typename Parse>
+bool for_each_line(const std::string &path, std::vector<char> &contents,
+                   Parse parse_line) {
+  char *line = contents.data();
+  char *end = contents.data() + contents.size() - 1;
+  for (long long line_number = 1; line < end; line_number++) {
+    char *line_end = static_cast<char *>(std::memchr(line, '\n', end - line));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    *line_end = '\0';
+    const char *problem = "cannot be parsed";
+    if (!parse_line(line, problem)) {
+      std::fprintf(stderr, "%s:%lld: %s\n", path.c_str(), line_number,
+                   problem);
+      return false;
+    }
+    line = line_end + 1;
+  }
+  return true;
+}
+
+void normalize_edges(std::vector<Edge> &edges) {
+  for (Edge &edge : edges) {
+    if (edge.first_vertex > edge.second_vertex) {
+      std::swap(edge.first_vertex, edge.second_vertex);
+    }
+  }
+  edges.erase(std::remove_if(edges.begin(), edges.end(),
+                             [](const Edge &edge) {
+                               return edge.first_vertex == edge.second_vertex;
+                             }),
+              edges.end());
+  std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+    if (a.first_vertex != b.first_vertex) {
+      return a.first_vertex < b.first_vertex;
+    }
+    if (a.second_vertex != b.second_vertex) {
+      return a.second_vertex < b.second_vertex;
+    }
+    return a.weight < b.weight;
+  });
+  edges.erase(std::unique(edges.begin(), edges.end(),
+                          [](const Edge &a, const Edge &b) {
+                            return a.first_vertex == b.first_vertex &&
+                                   a.second_vertex == b.second_vertex;
+                          }),
+              edges.end());
+}
+
+// read-only mapping of the whole file, nullptr when it is missing or
+// shorter than minimum_size
+void *map_file(const std::string &path, size_t minimum_size, size_t &size) {
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor == -1) {
+    return nullptr;
+  }
+  struct stat file_status;
+  if (fstat(descriptor, &file_status) != 0 ||
+      file_status.st_size < (off_t)minimum_size) {
+    close(descriptor);
+    return nullptr;
+  }
+  size = file_status.st_size;
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+  close(descriptor); // the mapping keeps the file referenced
+  return mapping == MAP_FAILED ? nullptr : mapping;
+}
+
+bool ends_with(const std::string &text, const std::string &suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// varint of at most 5 bytes that ends before `end`, like
+// Compressed_graph::read_varint but never reading past the list
+bool read_bounded_varint(const unsigned char *&position,
+                         const unsigned char *end, unsigned long long &value) {
+  value = 0;
+  for (int shift = 0; shift < 35 && position < end; shift += 7) {
+    unsigned char byte = *position++;
+    value |= (unsigned long long)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value <= 0xffffffffull;
+    }
+  }
+  return false;
+}
+
+// decodes every list once the way Compressed_graph::for_each_neighbour does:
+// each one has to fill exactly its offsets range, hold neighbours in
+// [0, vertices) and weights that fit an int, and the degrees have to add up
+// to arcs
+bool valid_compressed_lists(const Compressed_graph_header &header,
+                            const long long *offsets,
+                            const unsigned char *bytes) {
+  if (offsets[0] != 0) {
+    return false;
+  }
+  unsigned long long mask = (1ull << header.weight_bits) - 1;
+  long long arcs = 0;
+  for (long long vertex = 0; vertex < header.vertices; vertex++) {
+    if (offsets[vertex] > offsets[vertex + 1] ||
+        offsets[vertex + 1] > offsets[header.vertices]) {
+      return false;
+    }
+    const unsigned char *position = bytes + offsets[vertex];
+    const unsigned char *end = bytes + offsets[vertex + 1];
+    unsigned long long degree;
+    if (!read_bounded_varint(position, end, degree) ||
+        (long long)degree > end - position) {
+      return false;
+    }
+    const unsigned char *packed_weights = position;
+    position += (degree * header.weight_bits + 7) / 8;
+    if (position > end) {
+      return false;
+    }
+    long long neighbour = vertex;
+    for (unsigned long long i = 0; i < degree; i++) {
+      unsigned long long value;
+      if (!read_bounded_varint(position, end, value)) {
+        return false;
+      }
+      neighbour += i > 0 ? (long long)(int)value
+                         : (long long)((int)(value >> 1) ^ -(int)(value & 1));
+      if (neighbour < 0 || neighbour >= header.vertices) {
+        return false;
+      }
+      // the padding keeps this load inside the mapping
+      unsigned long long bit = i * header.weight_bits, word;
+      std::memcpy(&word, packed_weights + bit / 8, sizeof(word));
+      if ((long long)header.weight_base + ((word >> (bit % 8)) & mask) >
+          INT_MAX) {
+        return false;
+      }
+    }
+    if (position != end) {
+      return false;
+    }
+    arcs += degree;
+  }
+  return arcs == header.arcs;
+}
+
+} // namespace
+
+/*
+
+ TEXT FORMATS
+
+*/
+
+bool read_dimacs(const std::string &path, int &vertices,
+                 std::vector<Edge> &edges) {
+  std::vector<char> contents;
+  if (!read_file(path, contents)) {
+    return false;
+  }
+  vertices = 0;
+  edges.clear();
+
+  bool parsed = for_each_line(path, contents, [&](const char *line,
+                                                 const char *&problem) {
+    Line_parser parser(line);
+    long long first, second, weight;
+    switch (line[0]) {
+    case 'a':
+      parser.word("a");
+      if (!parser.number(first) || !parser.number(second) ||
+          !parser.number(weight)) {
+        problem = "expected \"a <u> <v> <w>\"";
+        return false;
+      }
+      if (first < 1 || second < 1 || first > vertices || second > vertices) {
+        problem = "vertex outside [1, n] of the \"p sp\" line";
+        return false;
+      }
+      if (weight < 1 || weight > INT_MAX) {
+        problem = "weight outside [1, 2147483647]";
+        return false;
+      }
+      edges.push_back({(int)first - 1, (int)second - 1, (int)weight});
+      return true;
+    case 'p':
+      if (!parser.word("p") || !parser.word("sp") ||
+          !parser.number(first) || !parser.number(second)) {
+        problem = "expected \"p sp <n> <m>\"";
+        return false;
+      }
+      if (first < 1 || first >= INT_MAX) {
+        problem = "vertex count outside [1, 2147483647)";
+        return false;
+      }
+      if (second < 0) {
+        problem = "negative arc count";
+        return false;
+      }
+      vertices = first;
+      // the count is only a hint, an "a" line takes at least 8 bytes
+      edges.reserve(std::min(second, (long long)contents.size() / 8));
+      return true;
+    default: // comments and empty lines
+      return true;
+    }
+  });
+  normalize_edges(edges);
+  return parsed;
+}
+
+bool read_edge_list(const std::string &path, int &vertices,
+                    std::vector<Edge> &edges) {
+  std::vector<char> contents;
+  if (!read_file(path, contents)) {
+    return false;
+  }
+  long long declared_vertices = -1, largest_vertex = -1;
+  edges.clear();
+
+  bool parsed = for_each_line(path, contents, [&](const char *line,
+                                                 const char *&problem) {
+    Line_parser parser(line);
+    if (parser.word("#")) {
+      long long count;
+      if (parser.word("vertices") && parser.number(count)) {
+        if (count < 1 || count >= INT_MAX) {
+          problem = "vertex count outside [1, 2147483647)";
+          return false;
+        }
+        if (largest_vertex >= count) {
+          problem = "vertex count not above a vertex of an earlier line";
+          return false;
+        }
+        declared_vertices = count;
+      }
+      return true;
+    }
+    if (parser.at_end()) {
+      return true;
+    }
+    long long first, second, weight;
+    if (!parser.number(first) || !parser.number(second) ||
+        !parser.number(weight)) {
+      problem = "expected \"first second weight\"";
+      return false;
+    }
+    if (first < 0 || second < 0 || first >= INT_MAX || second >= INT_MAX) {
+      problem = "vertex outside [0, 2147483647)";
+      return false;
+    }
+    if (weight < 1 || weight > INT_MAX) {
+      problem = "weight outside [1, 2147483647]";
+      return false;
+    }
+    if (declared_vertices != -1 &&
+        std::max(first, second) >= declared_vertices) {
+      problem = "vertex outside [0, n) of the \"# vertices\" line";
+      return false;
+    }
+    largest_vertex = std::max(largest_vertex, std::max(first, second));
+    edges.push_back({(int)first, (int)second, (int)weight});
+    return true;
+  });
+  vertices = declared_vertices != -1 ? declared_vertices : largest_vertex + 1;
+  normalize_edges(edges);
+  return parsed;
+}
+
+bool read_text_graph(const std::string &path, int &vertices,
+                     std::vector<Edge> &edges) {
+  return ends_with(path, ".gr") ? read_dimacs(path, vertices, edges)
+                                : read_edge_list(path, vertices, edges);
+}
+
+/*
+
+ BINARY FORMAT
+
+*/
+
+bool write_binary_graph(const std::string &path, const Csr_graph &graph) {
+  Binary_graph_header header = {};
+  std::memcpy(header.magic, binary_graph_magic, sizeof(header.magic));
+  header.version = binary_graph_version;
+  header.byte_order = native_byte_order;
+  header.vertices = graph.V;
+  header.arcs = graph.arcs();
+  header.offsets_position = page;
+  header.targets_position = page_align(header.offsets_position +
+                                       (graph.V + 1) * sizeof(long long));
+  header.weights_position =
+      page_align(header.targets_position + graph.arcs() * sizeof(int));
+  header.file_size =
+      page_align(header.weights_position + graph.arcs() * sizeof(int));
+
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  auto write_at = [&](long long position, const void *data, size_t bytes) {
+    return std::fseek(file, position, SEEK_SET) == 0 &&
+           std::fwrite(data, 1, bytes, file) == bytes;
+  };
+  long long empty_offsets = 0;
+  bool written =
+      write_at(0, &header, sizeof(header)) &&
+      write_at(header.offsets_position,
+               graph.V > 0 ? graph.offsets : &empty_offsets,
+               (graph.V + 1) * sizeof(long long)) &&
+      write_at(header.targets_position, graph.targets,
+               graph.arcs() * sizeof(int)) &&
+      write_at(header.weights_position, graph.weights,
+               graph.arcs() * sizeof(int));
+  // pad the last section so the file size matches the header
+  written = written && std::fseek(file, header.file_size - 1, SEEK_SET) == 0 &&
+            std::fputc(0, file) != EOF;
+  return std::fclose(file) == 0 && written;
+}
+
+bool map_binary_graph(const std::string &path, Csr_graph &graph) {
+  size_t size;
+  void *mapping = map_file(path, sizeof(Binary_graph_header), size);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  const Binary_graph_header &header =
+      *static_cast<const Binary_graph_header *>(mapping);
+  bool valid =
+      std::memcmp(header.magic, binary_graph_magic, sizeof(header.magic)) ==
+          0 &&
+      header.version == binary_graph_version &&
+      header.byte_order == native_byte_order && header.vertices >= 0 &&
+      header.vertices < INT_MAX && header.arcs >= 0 &&
+      header.file_size == (long long)size && header.offsets_position >= 0 &&
+      header.targets_position >= 0 && header.weights_position >= 0 &&
+      header.offsets_position + (header.vertices + 1) * 8 <= header.file_size &&
+      header.targets_position + header.arcs * 4 <= header.file_size &&
+      header.weights_position + header.arcs * 4 <= header.file_size;
+  const char *base = static_cast<const char *>(mapping);
+  // the searches index with these without checking: offsets have to run
+  // from 0 to arcs without decreasing, targets be vertices and weights
+  // positive
+  if (valid) {
+    const long long *offsets =
+        reinterpret_cast<const long long *>(base + header.offsets_position);
+    const int *targets =
+        reinterpret_cast<const int *>(base + header.targets_position);
+    const int *weights =
+        reinterpret_cast<const int *>(base + header.weights_position);
+    valid = offsets[0] == 0 && offsets[header.vertices] == header.arcs;
+    for (long long vertex = 0; valid && vertex < header.vertices; vertex++) {
+      valid = offsets[vertex] <= offsets[vertex + 1];
+    }
+    for (long long arc = 0; valid && arc < header.arcs; arc++) {
+      valid = targets[arc] >= 0 && targets[arc] < header.vertices &&
+              weights[arc] > 0;
+    }
+  }
+  if (!valid) {
+    munmap(mapping, size);
+    return false;
+  }
+
+  Csr_graph mapped;
+  mapped.mapping = mapping;
+  mapped.mapping_size = size;
+  mapped.V = header.vertices;
+  mapped.arc_count = header.arcs;
+  mapped.offsets =
+      reinterpret_cast<const long long *>(base + header.offsets_position);
+  mapped.targets = reinterpret_cast<const int *>(base + header.targets_position);
+  mapped.weights = reinterpret_cast<const int *>(base + header.weights_position);
+  graph = std::move(mapped);
+  return true;
+}
+
+bool load_graph(const std::string &path, Csr_graph &graph) {
+  if (ends_with(path, ".bin")) {
+    return map_binary_graph(path, graph);
+  }
+  int vertices;
+  std::vector<Edge> edges;
+  if (!read_text_graph(path, vertices, edges)) {
+    return false;
+  }
+  graph = Csr_graph(vertices, edges);
+  return true;
+}
+
+bool write_compressed_graph(const std::string &path,
+                            const Compressed_graph &graph) {
+  Compressed_graph_header header = {};
+  std::memcpy(header.magic, compressed_graph_magic, sizeof(header.magic));
+  header.version = compressed_graph_version;
+  header.byte_order = native_byte_order;
+  header.vertices = graph.V;
+  header.arcs = graph.arcs();
+  header.weight_base = graph.weight_base;
+  header.weight_bits = graph.weight_bits;
+  header.offsets_position = page;
+  header.bytes_position = page_align(header.offsets_position +
+                                     (graph.V + 1) * sizeof(long long));
+  header.byte_count = (graph.V > 0 ? graph.offsets[graph.V] : 0) +
+                      Compressed_graph::padding;
+  header.file_size = page_align(header.bytes_position + header.byte_count);
+
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  auto write_at = [&](long long position, const void *data, size_t bytes) {
+    return std::fseek(file, position, SEEK_SET) == 0 &&
+           std::fwrite(data, 1, bytes, file) == bytes;
+  };
+  long long empty_offsets = 0;
+  unsigned char empty_bytes[Compressed_graph::padding] = {};
+  bool written =
+      write_at(0, &header, sizeof(header)) &&
+      write_at(header.offsets_position,
+               graph.V > 0 ? graph.offsets : &empty_offsets,
+               (graph.V + 1) * sizeof(long long)) &&
+      write_at(header.bytes_position, graph.V > 0 ? graph.bytes : empty_bytes,
+               header.byte_count);
+  written = written && std::fseek(file, header.file_size - 1, SEEK_SET) == 0 &&
+            std::fputc(0, file) != EOF;
+  return std::fclose(file) == 0 && written;
+}
+
+bool map_compressed_graph(const std::string &path, Compressed_graph &graph) {
+  size_t size;
+  void *mapping = map_file(path, sizeof(Compressed_graph_header), size);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  const Compressed_graph_header &header =
+      *static_cast<const Compressed_graph_header *>(mapping);
+  const char *base = static_cast<const char *>(mapping);
+  bool valid =
+      std::memcmp(header.magic, compressed_graph_magic,
+                  sizeof(header.magic)) == 0 &&
+      header.version == compressed_graph_version &&
+      header.byte_order == native_byte_order && header.vertices >= 0 &&
+      header.vertices < INT_MAX && header.arcs >= 0 &&
+      header.weight_base >= 1 && header.weight_bits >= 0 &&
+      header.weight_bits <= 32 && header.file_size == (long long)size &&
+      header.offsets_position >= 0 && header.bytes_position >= 0 &&
+      header.offsets_position + (header.vertices + 1) * 8 <= header.file_size &&
+      header.bytes_position + header.byte_count <= header.file_size &&
+      header.byte_count >= Compressed_graph::padding;
+  // every list has to end before the padding, and the searches decode them
+  // without checking
+  if (valid) {
+    const long long *offsets =
+        reinterpret_cast<const long long *>(base + header.offsets_position);
+    valid = offsets[header.vertices] ==
+                header.byte_count - Compressed_graph::padding &&
+            valid_compressed_lists(
+                header, offsets,
+                reinterpret_cast<const unsigned char *>(
+                    base + header.bytes_position));
+  }
+  if (!valid) {
+    munmap(mapping, size);
+    return false;
+  }
+
+  Compressed_graph mapped;
+  mapped.mapping = mapping;
+  mapped.mapping_size = size;
+  mapped.V = header.vertices;
+  mapped.arc_count = header.arcs;
+  mapped.weight_base = header.weight_base;
+  mapped.weight_bits = header.weight_bits;
+  mapped.offsets =
+      reinterpret_cast<const long long *>(base + header.offsets_position);
+  mapped.bytes =
+      reinterpret_cast<const unsigned char *>(base + header.bytes_position);
+  graph = std::move(mapped);
+  return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "graph_generator.h"
+#include <string>
+#include <vector>
+
+// Text readers fill `vertices` and `edges` and return false when the file
+// cannot be opened or a line cannot be parsed, which is reported on stderr
+// with its line number. Weights have to be in [1, INT_MAX]. Arcs are turned
+// into undirected edges, self loops are dropped and of parallel edges only
+// the lightest one is kept.
+
+// DIMACS shortest path format: "c" comments, "p sp <n> <m>", "a <u> <v> <w>"
+// with vertices counted from 1
+bool read_dimacs(const std::string &path, int &vertices,
+                 std::vector<Edge> &edges);
+
+// "first second weight" lines with vertices counted from 0, "#" comments;
+// "# vertices <n>" (as written by write_edge_list) sets the vertex count,
+// otherwise it is the largest vertex + 1
+bool read_edge_list(const std::string &path, int &vertices,
+                    std::vector<Edge> &edges);
+
+// read_dimacs for .gr files, read_edge_list for anything else
+bool read_text_graph(const std::string &path, int &vertices,
+                     std::vector<Edge> &edges);
+
+// Binary graph file, version 1, native byte order:
+//   page 0       Binary_graph_header
+//   offsets      (V + 1) x int64, starts on a page boundary
+//   targets      arcs x int32, starts on a page boundary
+//   weights      arcs x int32, starts on a page boundary
+// The sections are exactly the Csr_graph arrays, so mapping the file is all
+// it takes to load it and processes mapping the same file share its pages.
+struct Binary_graph_header {
+  char magic[8];        // "PIAAGRPH"
+  unsigned version;     // binary_graph_version
+  unsigned byte_order;  // 0x01020304 as written by the producing machine
+  long long vertices;
+  long long arcs;
+  long long offsets_position; // byte positions in the file
+  long long targets_position;
+  long long weights_position;
+  long long file_size;
+};
+
+const unsigned binary_graph_version = 1;
+
+bool write_binary_graph(const std::string &path, const Csr_graph &graph);
+
+// maps the file read-only into `graph`, false when it is missing, truncated,
+// not a binary graph of this version or its arrays are inconsistent (offsets
+// not running from 0 to arcs, targets outside [0, V), weights below 1),
+// checked in one pass over the arrays
+bool map_binary_graph(const std::string &path, Csr_graph &graph);
+
+// any graph file by its extension: .bin files are mapped, text formats go
+// through read_text_graph into a Csr_graph
+bool load_graph(const std::string &path, Csr_graph &graph);
+
+// Compressed graph file, version 1, native byte order, same layout rules:
+//   page 0       Compressed_graph_header
+//   offsets      (V + 1) x int64, starts on a page boundary
+//   bytes        byte_count bytes of Compressed_graph lists and padding,
+//                starts on a page boundary
+struct Compressed_graph_header {
+  char magic[8];        // "PIAACGRF"
+  unsigned version;     // compressed_graph_version
+  unsigned byte_order;  // 0x01020304 as written by the producing machine
+  long long vertices;
+  long long arcs;
+  int weight_base;
+  int weight_bits;
+  long long offsets_position;
+  long long bytes_position;
+  long long byte_count;
+  long long file_size;
+};
+
+const unsigned compressed_graph_version = 1;
+
+bool write_compressed_graph(const std::string &path,
+                            const Compressed_graph &graph);
+// maps the file read-only into `graph`, false when it is missing, truncated,
+// not a compressed graph of this version or a list does not decode exactly
+// into its offsets range with neighbours in [0, V), checked in one pass
+bool map_compressed_graph(const std::string &path, Compressed_graph &graph);
+
+#endif // !GRAPH_IO_H
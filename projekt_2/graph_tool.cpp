@@ -0,0 +1,342 @@
+#include "batch_queries.h"
+#include "csr_graph.h"
+#include "graph_generator.h"
+#include "graph_io.h"
+#include "perf_counters.h"
+#include "reorder.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std::chrono;
+
+/*
+
+ Conversions between the graph formats and load time measurements:
+
+   graph_tool generate <vertices> <edges> <seed> <out.txt>
+   graph_tool convert <in.gr|in.txt> <out.bin>
+   graph_tool load <in.gr|in.txt> <in.bin>
+   graph_tool query <in.bin> <source> <destination>
+   graph_tool reorder <in.gr|in.txt|in.bin> [ordering ...]
+   graph_tool compress <in.gr|in.txt|in.bin> [out.cgr]
+
+*/
+
+namespace {
+
+// text formats only, for the commands that write the binary one
+bool read_text_csr(const std::string &path, Csr_graph &graph) {
+  int vertices;
+  std::vector<Edge> edges;
+  if (!read_text_graph(path, vertices, edges)) {
+    std::cout << "Could not read the graph from " << path << "\n";
+    return false;
+  }
+  graph = Csr_graph(vertices, edges);
+  return true;
+}
+
+bool map_graph(const std::string &path, Csr_graph &graph) {
+  if (!map_binary_graph(path, graph)) {
+    std::cout << "Could not map the binary graph " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool load_any_graph(const std::string &path, Csr_graph &graph) {
+  if (!load_graph(path, graph)) {
+    std::cout << "Could not load the graph from " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+// mean distance between the ids of neighbours, small when neighbours share
+// cache lines
+double mean_arc_span(const Csr_graph &graph) {
+  double span = 0;
+  for (int vertex = 0; vertex < graph.V; vertex++) {
+    for (long long arc = graph.offsets[vertex]; arc < graph.offsets[vertex + 1];
+         arc++) {
+      span += std::abs(graph.targets[arc] - vertex);
+    }
+  }
+  return graph.arcs() > 0 ? span / graph.arcs() : 0;
+}
+
+// Relabels the graph with every ordering and runs the same one-to-all
+// queries (in original ids) on each result. The checksum of the distances,
+// taken in original ids, must not depend on the ordering.
+void compare_orderings(const Csr_graph &graph,
+                       const std::vector<std::string> &orderings) {
+  const int queries = 8;
+  std::vector<int> sources(queries);
+  for (int query = 0; query < queries; query++) {
+    sources[query] = (query * 2654435761ull) % graph.V;
+  }
+
+  Perf_counters counters;
+  if (!counters.available()) {
+    std::cout << "Hardware counters are unavailable, cache misses are not "
+                 "reported\n";
+  }
+  std::cout << std::fixed << std::setprecision(1);
+  unsigned long long expected_checksum = 0;
+  for (size_t i = 0; i < orderings.size(); i++) {
+    steady_clock::time_point begin = steady_clock::now();
+    Vertex_order order = compute_vertex_order(graph, orderings[i]);
+    Csr_graph reordered = reorder(graph, order);
+    steady_clock::time_point end = steady_clock::now();
+    double reorder_time = duration<double, std::micro>(end - begin).count();
+
+    Dijkstra_workspace workspace(reordered.V);
+    workspace.run(reordered, order.to_new(sources[0])); // warm up
+    double query_time = 0;
+    long long cache_misses = 0;
+    unsigned long long checksum = 0;
+    for (int source : sources) {
+      counters.start();
+      begin = steady_clock::now();
+      workspace.run(reordered, order.to_new(source));
+      end = steady_clock::now();
+      counters.stop();
+      query_time += duration<double, std::micro>(end - begin).count();
+      cache_misses += counters.cache_misses();
+      for (int vertex = 0; vertex < graph.V; vertex++) {
+        checksum = checksum * 31 + workspace.distance(order.to_new(vertex));
+      }
+    }
+    if (i == 0) {
+      expected_checksum = checksum;
+    }
+
+    std::cout << std::left << std::setw(14) << orderings[i] << std::right
+              << "reorder " << std::setw(12) << reorder_time << " us"
+              << "  span " << std::setw(10) << mean_arc_span(reordered)
+              << "  query " << std::setw(10) << query_time / queries << " us";
+    if (counters.available()) {
+      std::cout << "  cache misses " << cache_misses / queries;
+    }
+    if (checksum != expected_checksum) {
+      std::cout << "  DISTANCES DIFFER";
+    }
+    std::cout << "\n";
+  }
+}
+
+// one-to-all queries from the same sources on both graphs, returns the mean
+// time of a query and adds the distances to the checksum
+template <class Adjacency>
+double mean_query_time(const Adjacency &graph, const std::vector<int> &sources,
+                       unsigned long long &checksum) {
+  Dijkstra_workspace workspace(graph.V);
+  workspace.run(graph, sources[0]); // warm up
+  double query_time = 0;
+  for (int source : sources) {
+    steady_clock::time_point begin = steady_clock::now();
+    workspace.run(graph, source);
+    steady_clock::time_point end = steady_clock::now();
+    query_time += duration<double, std::micro>(end - begin).count();
+    for (int vertex = 0; vertex < graph.V; vertex++) {
+      checksum = checksum * 31 + workspace.distance(vertex);
+    }
+  }
+  return query_time / sources.size();
+}
+
+// bytes per undirected edge and query time of the CSR and compressed graph
+void compare_compressed(const Csr_graph &graph,
+                        const Compressed_graph &compressed) {
+  std::vector<int> sources(8);
+  for (size_t query = 0; query < sources.size(); query++) {
+    sources[query] = (query * 2654435761ull) % graph.V;
+  }
+  double edges = std::max(1ll, graph.arcs() / 2);
+  double csr_bytes = (graph.V + 1) * sizeof(long long) +
+                     graph.arcs() * (sizeof(int) + sizeof(int));
+  unsigned long long csr_checksum = 0, compressed_checksum = 0;
+  double csr_time = mean_query_time(graph, sources, csr_checksum);
+  double compressed_time =
+      mean_query_time(compressed, sources, compressed_checksum);
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Weights: " << compressed.weight_bits << " bits above "
+            << compressed.weight_base << "\n";
+  std::cout << "CSR:        " << csr_bytes / edges << " bytes/edge, "
+            << csr_time << " us per one-to-all query\n";
+  std::cout << "Compressed: " << compressed.memory_bytes() / edges
+            << " bytes/edge (lists alone "
+            << compressed.offsets[compressed.V] / edges << "), "
+            << compressed_time << " us per one-to-all query\n";
+  std::cout << "Size " << compressed.memory_bytes() / csr_bytes
+            << "x, query time " << compressed_time / csr_time << "x\n";
+  if (csr_checksum != compressed_checksum) {
+    std::cout << "DISTANCES DIFFER\n";
+  }
+}
+
+int print_usage() {
+  std::cout << "usage: graph_tool generate <vertices> <edges> <seed> <out.txt>\n"
+               "       graph_tool convert <in.gr|in.txt> <out.bin>\n"
+               "       graph_tool load <in.gr|in.txt> <in.bin>\n"
+               "       graph_tool query <in.bin> <source> <destination>\n"
+               "       graph_tool reorder <in.gr|in.txt|in.bin> "
+               "[identity|degree|bfs|cuthill_mckee|partition ...]\n"
+               "       graph_tool compress <in.gr|in.txt|in.bin> [out.cgr]\n";
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    return print_usage();
+  }
+  std::string command = argv[1];
+
+  if (command == "generate" && argc == 6) {
+    steady_clock::time_point begin = steady_clock::now();
+    Graph_generator generator(std::atoi(argv[2]), std::atoll(argv[3]),
+                              std::strtoull(argv[4], nullptr, 10),
+                              std::max(1u, std::thread::hardware_concurrency()));
+    if (!generator.write(argv[5])) {
+      std::cout << "Could not write " << argv[5] << "\n";
+      return 1;
+    }
+    steady_clock::time_point end = steady_clock::now();
+    std::cout << "Generating and writing the graph took: "
+              << duration_cast<microseconds>(end - begin).count() << " us\n";
+    return 0;
+  }
+
+  if (command == "convert" && argc == 4) {
+    Csr_graph graph;
+    if (!read_text_csr(argv[2], graph)) {
+      return 1;
+    }
+    if (!write_binary_graph(argv[3], graph)) {
+      std::cout << "Could not write " << argv[3] << "\n";
+      return 1;
+    }
+    std::cout << "|V| = " << graph.V << "\tE = " << graph.arcs() / 2 << "\n";
+    return 0;
+  }
+
+  if (command == "load" && argc == 4) {
+    Csr_graph parsed, mapped;
+    steady_clock::time_point begin = steady_clock::now();
+    if (!read_text_csr(argv[2], parsed)) {
+      return 1;
+    }
+    steady_clock::time_point end = steady_clock::now();
+    std::cout << "|V| = " << parsed.V << "\tE = " << parsed.arcs() / 2 << "\n";
+    std::cout << "Parsing the text graph took: "
+              << duration_cast<microseconds>(end - begin).count() << " us\n";
+
+    begin = steady_clock::now();
+    if (!map_graph(argv[3], mapped)) {
+      return 1;
+    }
+    end = steady_clock::now();
+    std::cout << "Mapping the binary graph took: "
+              << duration_cast<microseconds>(end - begin).count() << " us\n";
+
+    // the mapping is lazy, this pays for reading every page once
+    begin = steady_clock::now();
+    long long weight_sum = 0;
+    for (long long arc = 0; arc < mapped.arcs(); arc++) {
+      weight_sum += mapped.weights[arc] + mapped.targets[arc];
+    }
+    weight_sum += mapped.offsets[mapped.V];
+    end = steady_clock::now();
+    std::cout << "Touching every page of the mapped graph took: "
+              << duration_cast<microseconds>(end - begin).count() << " us ("
+              << weight_sum << ")\n";
+    return 0;
+  }
+
+  if (command == "query" && argc == 5) {
+    Csr_graph graph;
+    if (!map_graph(argv[2], graph)) {
+      return 1;
+    }
+    int source = std::atoi(argv[3]), destination = std::atoi(argv[4]);
+    if (source < 0 || source >= graph.V || destination < 0 ||
+        destination >= graph.V) {
+      std::cout << "Vertices must be in [0, " << graph.V << ")\n";
+      return 1;
+    }
+    Dijkstra_workspace workspace(graph.V);
+    int distance = workspace.run(graph, source, destination);
+    if (distance == unreached_distance) {
+      std::cout << "No path exists from source vertex " << source
+                << " to destination vertex " << destination << "\n";
+      return 0;
+    }
+    std::cout << "Distance = " << distance << ", Path: ";
+    for (int vertex : workspace.path_to(destination)) {
+      std::cout << vertex << " -> ";
+    }
+    std::cout << "and back\n";
+    return 0;
+  }
+
+  if (command == "reorder" && argc >= 3) {
+    std::vector<std::string> orderings = {"identity", "degree", "bfs",
+                                          "cuthill_mckee", "partition"};
+    if (argc > 3) {
+      orderings.assign(argv + 3, argv + argc);
+    }
+    for (const std::string &ordering : orderings) {
+      if (!is_vertex_ordering(ordering)) {
+        return print_usage();
+      }
+    }
+    Csr_graph graph;
+    if (!load_any_graph(argv[2], graph)) {
+      return 1;
+    }
+    if (graph.V == 0) {
+      std::cout << "The graph has no vertices\n";
+      return 1;
+    }
+    std::cout << "|V| = " << graph.V << "\tE = " << graph.arcs() / 2 << "\n";
+    compare_orderings(graph, orderings);
+    return 0;
+  }
+
+  if (command == "compress" && (argc == 3 || argc == 4)) {
+    Csr_graph graph;
+    if (!load_any_graph(argv[2], graph)) {
+      return 1;
+    }
+    if (graph.V == 0) {
+      std::cout << "The graph has no vertices\n";
+      return 1;
+    }
+    std::cout << "|V| = " << graph.V << "\tE = " << graph.arcs() / 2 << "\n";
+    steady_clock::time_point begin = steady_clock::now();
+    Compressed_graph compressed(graph);
+    steady_clock::time_point end = steady_clock::now();
+    std::cout << "Compressing the graph took: "
+              << duration_cast<microseconds>(end - begin).count() << " us\n";
+    if (argc == 4 && !write_compressed_graph(argv[3], compressed)) {
+      std::cout << "Could not write " << argv[3] << "\n";
+      return 1;
+    }
+    // compare against the mapped file when there is one
+    if (argc == 4 && !map_compressed_graph(argv[3], compressed)) {
+      std::cout << "Could not map the compressed graph " << argv[3] << "\n";
+      return 1;
+    }
+    compare_compressed(graph, compressed);
+    return 0;
+  }
+
+  return print_usage();
+}
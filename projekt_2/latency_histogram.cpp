@@ -0,0 +1,63 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cstdio>
+
+Latency_histogram::Latency_histogram() {
+  for (auto &count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+int Latency_histogram::bucket_of(long long nanoseconds) {
+  if (nanoseconds < sub_buckets) {
+    return std::max(0LL, nanoseconds);
+  }
+  int exponent = 63 - __builtin_clzll(nanoseconds); // >= 4
+  int sub_bucket = (nanoseconds >> (exponent - 4)) - sub_buckets;
+  return std::min(bucket_count - 1,
+                  sub_buckets + (exponent - 4) * sub_buckets + sub_bucket);
+}
+
+long long Latency_histogram::bucket_middle(int bucket) {
+  if (bucket < sub_buckets) {
+    return bucket;
+  }
+  int shift = (bucket - sub_buckets) / sub_buckets;
+  long long low = (long long)(sub_buckets + bucket % sub_buckets) << shift;
+  return low + ((1LL << shift) >> 1);
+}
+
+void Latency_histogram::record(long long nanoseconds) {
+  counts[bucket_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  total.fetch_add(1, std::memory_order_relaxed);
+  long long seen = max_value.load(std::memory_order_relaxed);
+  while (nanoseconds > seen &&
+         !max_value.compare_exchange_weak(seen, nanoseconds,
+                                          std::memory_order_relaxed)) {
+  }
+}
+
+long long Latency_histogram::percentile(double fraction) const {
+  long long recorded = count();
+  if (recorded == 0) {
+    return 0;
+  }
+  long long rank = std::max(1LL, (long long)(fraction * recorded + 0.5));
+  long long seen = 0;
+  for (int bucket = 0; bucket < bucket_count; bucket++) {
+    seen += counts[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucket_middle(bucket), max());
+    }
+  }
+  return max();
+}
+
+std::string Latency_histogram::summary() const {
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "count %lld p50 %.3f p99 %.3f p999 %.3f max %.3f us", count(),
+                percentile(0.5) / 1000.0, percentile(0.99) / 1000.0,
+                percentile(0.999) / 1000.0, max() / 1000.0);
+  return line;
+}
@@ -0,0 +1,272 @@
+#include "latency_histogram.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono;
+
+/*
+
+ Load generator for shortest_path_server.
+
+   shortest_path_client queries <count> <vertices> <seed> <out.txt>
+   shortest_path_client replay <socket> <queries.txt> [--connections 4]
+                        [--window 16] [--repeat 1]
+
+ replay spreads the query file round robin over the connections, keeps up
+ to --window queries in flight on each of them and reports the latency seen
+ by the client, the achieved queries/s and the server's own stats.
+
+*/
+
+namespace {
+
+int connect_to(const std::string &path) {
+  int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (connection == -1 || path.size() >= sizeof(address.sun_path)) {
+    return -1;
+  }
+  std::strcpy(address.sun_path, path.c_str());
+  if (connect(connection, (sockaddr *)&address, sizeof(address)) != 0) {
+    close(connection);
+    return -1;
+  }
+  return connection;
+}
+
+// sends the queries over one connection and records their latencies
+bool replay_connection(const std::string &path,
+                       const std::vector<std::string> &queries, int window,
+                       Latency_histogram &latencies,
+                       std::atomic<long long> &unanswered) {
+  int connection = connect_to(path);
+  if (connection == -1) {
+    return false;
+  }
+  FILE *in = fdopen(connection, "r");
+  if (in == nullptr) {
+    close(connection);
+    return false;
+  }
+  int duplicate = dup(connection);
+  FILE *out = duplicate == -1 ? nullptr : fdopen(duplicate, "w");
+  if (out == nullptr) {
+    if (duplicate != -1) {
+      close(duplicate);
+    }
+    std::fclose(in);
+    return false;
+  }
+
+  std::vector<steady_clock::time_point> sent(queries.size());
+  std::mutex mutex;
+  std::condition_variable answered;
+  size_t answers = 0;
+  bool server_gone = false;
+
+  std::thread reader([&] {
+    char buffer[1 << 16];
+    for (size_t query = 0; query < queries.size(); query++) {
+      if (std::fgets(buffer, sizeof(buffer), in) == nullptr) {
+        unanswered += queries.size() - query;
+        std::lock_guard<std::mutex> lock(mutex);
+        server_gone = true; // stops the writer
+        answered.notify_one();
+        return;
+      }
+      steady_clock::time_point now = steady_clock::now();
+      std::lock_guard<std::mutex> lock(mutex);
+      latencies.record(duration_cast<nanoseconds>(now - sent[query]).count());
+      answers++;
+      answered.notify_one();
+    }
+  });
+
+  for (size_t query = 0; query < queries.size(); query++) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      answered.wait(lock, [&] {
+        return server_gone || query - answers < (size_t)window;
+      });
+      if (server_gone) {
+        break;
+      }
+      sent[query] = steady_clock::now();
+    }
+    bool written = std::fputs(queries[query].c_str(), out) != EOF &&
+                   std::fputc('\n', out) != EOF;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      // flush when the window is full or nothing else is left to send
+      if (written && (query + 1 - answers >= (size_t)window ||
+                      query + 1 == queries.size())) {
+        written = std::fflush(out) == 0;
+      }
+    }
+    if (!written) {
+      // the reader then sees the end of the stream and counts the rest
+      shutdown(connection, SHUT_RDWR);
+      break;
+    }
+  }
+  std::fflush(out);
+  reader.join();
+  std::fputs("quit\n", out);
+  std::fclose(out);
+  std::fclose(in);
+  return true;
+}
+
+std::string server_stats(const std::string &path) {
+  int connection = connect_to(path);
+  if (connection == -1) {
+    return "unavailable";
+  }
+  const char request[] = "stats\nquit\n";
+  if (write(connection, request, sizeof(request) - 1) < 0) {
+    close(connection);
+    return "unavailable";
+  }
+  FILE *in = fdopen(connection, "r");
+  if (in == nullptr) {
+    close(connection);
+    return "unavailable";
+  }
+  char buffer[512] = "";
+  if (std::fgets(buffer, sizeof(buffer), in) == nullptr) {
+    buffer[0] = '\0';
+  }
+  std::fclose(in);
+  std::string line(buffer);
+  if (!line.empty() && line.back() == '\n') {
+    line.pop_back();
+  }
+  return line;
+}
+
+int write_queries(long long count, int vertices, unsigned long long seed,
+                  const std::string &path) {
+  std::ofstream file(path);
+  if (!file || vertices < 2) {
+    std::cerr << "Could not write " << path << "\n";
+    return 1;
+  }
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int> vertex(0, vertices - 1);
+  for (long long query = 0; query < count; query++) {
+    int source = vertex(rng), destination = vertex(rng);
+    while (destination == source) {
+      destination = vertex(rng);
+    }
+    file << source << " " << destination << "\n";
+  }
+  return 0;
+}
+
+int print_usage() {
+  std::cerr << "usage: shortest_path_client queries <count> <vertices> <seed> "
+               "<out.txt>\n"
+               "       shortest_path_client replay <socket> <queries.txt> "
+               "[--connections 4] [--window 16] [--repeat 1]\n";
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // a server going away makes writes fail with EPIPE instead of killing the
+  // client, replay_connection then counts the rest as unanswered
+  std::signal(SIGPIPE, SIG_IGN);
+
+  if (argc == 6 && std::string(argv[1]) == "queries") {
+    return write_queries(std::atoll(argv[2]), std::atoi(argv[3]),
+                         std::strtoull(argv[4], nullptr, 10), argv[5]);
+  }
+  if (argc < 4 || std::string(argv[1]) != "replay") {
+    return print_usage();
+  }
+
+  std::string socket_path = argv[2];
+  int connections = 4, window = 16, repeat = 1;
+  for (int i = 4; i < argc; i += 2) {
+    std::string option = argv[i];
+    if (i + 1 == argc) {
+      std::cerr << "Missing the value of " << option << "\n";
+      return print_usage();
+    }
+    if (option == "--connections") {
+      connections = std::max(1, std::atoi(argv[i + 1]));
+    } else if (option == "--window") {
+      window = std::max(1, std::atoi(argv[i + 1]));
+    } else if (option == "--repeat") {
+      repeat = std::max(1, std::atoi(argv[i + 1]));
+    } else {
+      return print_usage();
+    }
+  }
+
+  std::ifstream file(argv[3]);
+  if (!file) {
+    std::cerr << "Could not read " << argv[3] << "\n";
+    return 1;
+  }
+  std::vector<std::vector<std::string>> per_connection(connections);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+  for (int round = 0; round < repeat; round++) {
+    for (size_t query = 0; query < lines.size(); query++) {
+      per_connection[query % connections].push_back(lines[query]);
+    }
+  }
+
+  Latency_histogram latencies;
+  std::atomic<long long> unanswered(0);
+  std::atomic<int> failed(0);
+  steady_clock::time_point begin = steady_clock::now();
+  std::vector<std::thread> clients;
+  for (int connection = 0; connection < connections; connection++) {
+    clients.emplace_back([&, connection] {
+      if (!replay_connection(socket_path, per_connection[connection], window,
+                             latencies, unanswered)) {
+        failed++;
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  steady_clock::time_point end = steady_clock::now();
+
+  if (failed > 0) {
+    std::cerr << failed << " connections to " << socket_path << " failed\n";
+    return 1;
+  }
+  double seconds = duration<double>(end - begin).count();
+  std::cout << "Client latency: " << latencies.summary() << "\n";
+  std::cout << "Throughput: " << latencies.count() / seconds
+            << " queries/s over " << connections << " connections, "
+            << unanswered << " unanswered\n";
+  std::cout << "Server: " << server_stats(socket_path) << "\n";
+  return unanswered > 0 ? 1 : 0;
+}
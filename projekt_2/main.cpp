@@ -49,4 +49,15 @@ int main() {
   // Matrix_graph(1000, 0.5);
   // Matrix_graph(1000, 0.75);
   // Matrix_graph(1000, 1);
+  //
+  // delta-stepping scaling, ~100k, ~1M and ~10M edges
+  // List_graph(100000, 0.00002);
+  // List_graph(100000, 0.0002);
+  // List_graph(100000, 0.002);
+  //
+  // packed matrix footprint and query times
+  // Matrix_graph(1000, 0.5);
+  // Matrix_graph(5000, 0.5);
+  // Matrix_graph(10000, 0.25);
+  // Matrix_graph(20000, 0.1);
 }
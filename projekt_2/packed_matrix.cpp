@@ -0,0 +1,84 @@
+#include "packed_matrix.h"
+#include "dijkstra.h"
+#include <cstring>
+#include <new>
+
+Packed_matrix_graph::Packed_matrix_graph(int vertices,
+                                         const std::vector<Edge> &edges)
+    : V(vertices) {
+  stride = (V + 63) / 64 * 64;
+  words_per_row = stride / 64;
+  size_t weight_bytes = (size_t)V * stride;
+  size_t presence_bytes = (size_t)V * words_per_row * sizeof(uint64_t);
+  // aligned_alloc wants a multiple of the alignment, both sizes already are
+  weights.reset(static_cast<uint8_t *>(
+      std::aligned_alloc(64, weight_bytes > 0 ? weight_bytes : 64)));
+  presence.reset(static_cast<uint64_t *>(
+      std::aligned_alloc(64, presence_bytes > 0 ? presence_bytes : 64)));
+  if (!weights || !presence) {
+    throw std::bad_alloc();
+  }
+  std::memset(weights.get(), 0, weight_bytes);
+  std::memset(presence.get(), 0, presence_bytes);
+
+  for (const Edge &edge : edges) {
+    insert_edge(edge.first_vertex, edge.second_vertex, edge.weight);
+  }
+}
+
+Packed_matrix_graph::Packed_matrix_graph(
+    const std::vector<std::vector<int>> &adj)
+    : Packed_matrix_graph(adj.size(), {}) {
+  for (int from = 0; from < V; from++) {
+    for (int to = from + 1; to < V; to++) {
+      if (adj[from][to] != 0) {
+        insert_edge(from, to, adj[from][to]);
+      }
+    }
+  }
+}
+
+void Packed_matrix_graph::insert_edge(int first_vertex, int second_vertex,
+                                      int weight) {
+  weights[(long long)first_vertex * stride + second_vertex] = weight;
+  weights[(long long)second_vertex * stride + first_vertex] = weight;
+  presence[(long long)first_vertex * words_per_row + second_vertex / 64] |=
+      1ULL << (second_vertex % 64);
+  presence[(long long)second_vertex * words_per_row + first_vertex / 64] |=
+      1ULL << (first_vertex % 64);
+}
+
+size_t Packed_matrix_graph::memory_bytes() const {
+  return packed_matrix_bytes(V);
+}
+
+size_t packed_matrix_bytes(int vertices) {
+  size_t stride = (vertices + 63) / 64 * 64;
+  return vertices * stride + vertices * (stride / 64) * sizeof(uint64_t);
+}
+
+size_t nested_matrix_bytes(int vertices) {
+  // outer vector, then one vector object and one heap block per row
+  return sizeof(std::vector<std::vector<int>>) +
+         (size_t)vertices * (sizeof(std::vector<int>) + vertices * sizeof(int));
+}
+
+
+Sssp_result Packed_matrix_graph::dijkstra_to_others(int source) const {
+  Distance_vector distances(V, unreached_distance);
+  Binary_heap_queue queue;
+  Record_parents paths(V);
+  dijkstra(*this, source, distances, queue, All_targets(), paths);
+  Sssp_result result;
+  result.distances = std::move(distances.values);
+  result.parents = std::move(paths.parents);
+  return result;
+}
+
+int Packed_matrix_graph::dijkstra_to_chosen(int source, int destination) const {
+  Distance_vector distances(V, unreached_distance);
+  Binary_heap_queue queue;
+  No_paths paths;
+  dijkstra(*this, source, distances, queue, Single_target{destination}, paths);
+  return distances.get(destination);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef PACKED_MATRIX_H
+#define PACKED_MATRIX_H
+
+#include "delta_stepping.h"
+#include "graph_generator.h"
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Adjacency matrix with one byte per cell (weights are 1..20) in a single
+// cache line aligned buffer, rows padded to 64 cells. Next to it every row
+// has a bitset of present edges, so the neighbours of a vertex are found a
+// word of 64 cells at a time instead of testing every cell.
+class Packed_matrix_graph {
+  struct Free_deleter {
+    void operator()(void *buffer) const { std::free(buffer); }
+  };
+  std::unique_ptr<uint8_t[], Free_deleter> weights;
+  std::unique_ptr<uint64_t[], Free_deleter> presence;
+
+public:
+  int V;
+  int stride;         // bytes per weight row, multiple of 64
+  int words_per_row;  // presence words per row, stride / 64
+
+  Packed_matrix_graph(int vertices, const std::vector<Edge> &edges);
+  explicit Packed_matrix_graph(const std::vector<std::vector<int>> &adj);
+
+  void insert_edge(int first_vertex, int second_vertex, int weight);
+  int weight(int from, int to) const {
+    return weights[(long long)from * stride + to];
+  }
+  size_t memory_bytes() const;
+
+  // visit(neighbour, weight) for the set bits of the presence row
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    const uint64_t *row = presence.get() + (long long)vertex * words_per_row;
+    for (int word = 0; word < words_per_row; word++) {
+      uint64_t bits = row[word];
+      while (bits != 0) {
+        int neighbour = word * 64 + __builtin_ctzll(bits);
+        bits &= bits - 1;
+        visit(neighbour, weight(vertex, neighbour));
+      }
+    }
+  }
+
+  // same conventions as List_graph::dijkstra_to_others, the smallest
+  // (distance, id) tight neighbour as parent, but unreached_distance for
+  // unreached vertices
+  Sssp_result dijkstra_to_others(int source) const;
+  // distance to destination, unreached_distance when there is no path
+  int dijkstra_to_chosen(int source, int destination) const;
+};
+
+// what std::vector<std::vector<int>> of Matrix_graph needs for |V| vertices
+size_t nested_matrix_bytes(int vertices);
+// what Packed_matrix_graph needs for |V| vertices
+size_t packed_matrix_bytes(int vertices);
+
+#endif // !PACKED_MATRIX_H
@@ -0,0 +1,64 @@
+#include "perf_counters.h"
+#include <cstring>
+#include <initializer_list>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int open_counter(unsigned long long config) {
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.config = config;
+  attributes.disabled = 1;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+long long read_counter(int fd) {
+  long long value;
+  if (fd == -1 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+    return -1;
+  }
+  return value;
+}
+
+} // namespace
+
+Perf_counters::Perf_counters() {
+  cycles_fd = open_counter(PERF_COUNT_HW_CPU_CYCLES);
+  cache_misses_fd = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+}
+
+Perf_counters::~Perf_counters() {
+  if (cycles_fd != -1) {
+    close(cycles_fd);
+  }
+  if (cache_misses_fd != -1) {
+    close(cache_misses_fd);
+  }
+}
+
+void Perf_counters::start() {
+  for (int fd : {cycles_fd, cache_misses_fd}) {
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void Perf_counters::stop() {
+  for (int fd : {cycles_fd, cache_misses_fd}) {
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  cycles_count = read_counter(cycles_fd);
+  cache_misses_count = read_counter(cache_misses_fd);
+}
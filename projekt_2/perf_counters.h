@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// CPU cycles and last level cache misses of the calling thread, read through
+// perf_event_open. Kernels without hardware counters (most virtual machines,
+// perf_event_paranoid > 2) leave the counters unavailable, then every reading
+// is -1 and start/stop do nothing.
+class Perf_counters {
+  int cycles_fd = -1;
+  int cache_misses_fd = -1;
+  long long cycles_count = -1, cache_misses_count = -1;
+
+public:
+  Perf_counters();
+  ~Perf_counters();
+  Perf_counters(const Perf_counters &) = delete;
+  Perf_counters &operator=(const Perf_counters &) = delete;
+
+  bool available() const { return cycles_fd != -1 || cache_misses_fd != -1; }
+
+  // counts only between start and stop, every start resets the counters
+  void start();
+  void stop();
+  long long cycles() const { return cycles_count; }
+  long long cache_misses() const { return cache_misses_count; }
+};
+
+#endif // !PERF_COUNTERS_H
@@ -0,0 +1,285 @@
+#include "reorder.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+int degree(const Csr_graph &graph, int vertex) {
+  return graph.offsets[vertex + 1] - graph.offsets[vertex];
+}
+
+Vertex_order from_sequence(std::vector<int> sequence) {
+  Vertex_order order;
+  order.new_id.resize(sequence.size());
+  for (size_t position = 0; position < sequence.size(); position++) {
+    order.new_id[sequence[position]] = position;
+  }
+  order.old_id = std::move(sequence);
+  return order;
+}
+
+std::vector<int> degree_sequence(const Csr_graph &graph) {
+  std::vector<int> sequence(graph.V);
+  std::iota(sequence.begin(), sequence.end(), 0);
+  std::stable_sort(sequence.begin(), sequence.end(), [&](int a, int b) {
+    return degree(graph, a) > degree(graph, b);
+  });
+  return sequence;
+}
+
+std::vector<int> bfs_sequence(const Csr_graph &graph) {
+  std::vector<int> sequence;
+  sequence.reserve(graph.V);
+  std::vector<char> visited(graph.V, 0);
+  for (int root = 0; root < graph.V; root++) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = 1;
+    sequence.push_back(root);
+    for (size_t tail = sequence.size() - 1; tail < sequence.size(); tail++) {
+      int vertex = sequence[tail];
+      for (long long arc = graph.offsets[vertex];
+           arc < graph.offsets[vertex + 1]; arc++) {
+        if (!visited[graph.targets[arc]]) {
+          visited[graph.targets[arc]] = 1;
+          sequence.push_back(graph.targets[arc]);
+        }
+      }
+    }
+  }
+  return sequence;
+}
+
+// level structure of the component of root; returns the depth and leaves
+// the last level at the end of `levels`
+int bfs_levels(const Csr_graph &graph, int root, std::vector<int> &level_of,
+               std::vector<int> &levels, size_t &last_level) {
+  levels.assign(1, root);
+  level_of[root] = 0;
+  last_level = 0;
+  for (size_t tail = 0; tail < levels.size(); tail++) {
+    int vertex = levels[tail];
+    if (level_of[vertex] != level_of[levels[last_level]]) {
+      last_level = tail;
+    }
+    for (long long arc = graph.offsets[vertex]; arc < graph.offsets[vertex + 1];
+         arc++) {
+      if (level_of[graph.targets[arc]] == -1) {
+        level_of[graph.targets[arc]] = level_of[vertex] + 1;
+        levels.push_back(graph.targets[arc]);
+      }
+    }
+  }
+  int depth = level_of[levels.back()];
+  for (int vertex : levels) {
+    level_of[vertex] = -1;
+  }
+  return depth;
+}
+
+// George & Liu: restart from the smallest degree vertex of the deepest level
+// until the level structure stops getting deeper
+int pseudo_peripheral(const Csr_graph &graph, int root,
+                      std::vector<int> &level_of) {
+  std::vector<int> levels;
+  size_t last_level;
+  int depth = bfs_levels(graph, root, level_of, levels, last_level);
+  for (int attempt = 0; attempt < 8; attempt++) {
+    int candidate = levels[last_level];
+    for (size_t i = last_level; i < levels.size(); i++) {
+      if (degree(graph, levels[i]) < degree(graph, candidate)) {
+        candidate = levels[i];
+      }
+    }
+    int candidate_depth =
+        bfs_levels(graph, candidate, level_of, levels, last_level);
+    if (candidate_depth <= depth) {
+      break;
+    }
+    root = candidate;
+    depth = candidate_depth;
+  }
+  return root;
+}
+
+std::vector<int> cuthill_mckee_sequence(const Csr_graph &graph) {
+  std::vector<int> sequence;
+  sequence.reserve(graph.V);
+  std::vector<char> visited(graph.V, 0);
+  std::vector<int> level_of(graph.V, -1);
+  std::vector<int> children;
+  // components are started from their smallest degree vertex
+  std::vector<int> by_degree = degree_sequence(graph);
+  std::reverse(by_degree.begin(), by_degree.end());
+  for (int seed : by_degree) {
+    if (visited[seed]) {
+      continue;
+    }
+    int root = pseudo_peripheral(graph, seed, level_of);
+    visited[root] = 1;
+    sequence.push_back(root);
+    for (size_t tail = sequence.size() - 1; tail < sequence.size(); tail++) {
+      int vertex = sequence[tail];
+      children.clear();
+      for (long long arc = graph.offsets[vertex];
+           arc < graph.offsets[vertex + 1]; arc++) {
+        if (!visited[graph.targets[arc]]) {
+          visited[graph.targets[arc]] = 1;
+          children.push_back(graph.targets[arc]);
+        }
+      }
+      std::stable_sort(children.begin(), children.end(), [&](int a, int b) {
+        return degree(graph, a) < degree(graph, b);
+      });
+      sequence.insert(sequence.end(), children.begin(), children.end());
+    }
+  }
+  std::reverse(sequence.begin(), sequence.end());
+  return sequence;
+}
+
+std::vector<int> partition_sequence(const Csr_graph &graph, int part_size) {
+  std::vector<int> sequence;
+  sequence.reserve(graph.V);
+  std::vector<char> assigned(graph.V, 0);
+  std::vector<int> frontier; // reached by the previous part, still free
+  int next_free = 0;
+  while ((int)sequence.size() < graph.V) {
+    // a new part starts next to the previous one when possible
+    int seed = -1;
+    for (int vertex : frontier) {
+      if (!assigned[vertex]) {
+        seed = vertex;
+        break;
+      }
+    }
+    if (seed == -1) {
+      while (assigned[next_free]) {
+        next_free++;
+      }
+      seed = next_free;
+    }
+
+    std::vector<int> queue(1, seed);
+    size_t part_begin = sequence.size();
+    assigned[seed] = 1;
+    sequence.push_back(seed);
+    for (size_t head = 0; head < queue.size() &&
+                          (int)(sequence.size() - part_begin) < part_size;
+         head++) {
+      int vertex = queue[head];
+      for (long long arc = graph.offsets[vertex];
+           arc < graph.offsets[vertex + 1] &&
+           (int)(sequence.size() - part_begin) < part_size;
+           arc++) {
+        int target = graph.targets[arc];
+        if (!assigned[target]) {
+          assigned[target] = 1;
+          sequence.push_back(target);
+          queue.push_back(target);
+        }
+      }
+    }
+    // free neighbours of the part seed the next one
+    frontier.clear();
+    for (size_t i = part_begin; i < sequence.size(); i++) {
+      int vertex = sequence[i];
+      for (long long arc = graph.offsets[vertex];
+           arc < graph.offsets[vertex + 1]; arc++) {
+        if (!assigned[graph.targets[arc]]) {
+          frontier.push_back(graph.targets[arc]);
+        }
+      }
+    }
+  }
+  return sequence;
+}
+
+} // namespace
+
+Sssp_result Vertex_order::to_original(const Sssp_result &result) const {
+  Sssp_result original;
+  original.distances.resize(result.distances.size());
+  original.parents.resize(result.parents.size());
+  for (size_t vertex = 0; vertex < result.distances.size(); vertex++) {
+    original.distances[old_id[vertex]] = result.distances[vertex];
+    int parent = result.parents[vertex];
+    original.parents[old_id[vertex]] = parent == -1 ? -1 : old_id[parent];
+  }
+  return original;
+}
+
+std::vector<int> Vertex_order::to_original(const std::vector<int> &path) const {
+  std::vector<int> original(path.size());
+  for (size_t i = 0; i < path.size(); i++) {
+    original[i] = old_id[path[i]];
+  }
+  return original;
+}
+
+bool is_vertex_ordering(const std::string &name) {
+  return name == "identity" || name == "degree" || name == "bfs" ||
+         name == "cuthill_mckee" || name == "partition";
+}
+
+Vertex_order compute_vertex_order(const Csr_graph &graph,
+                                  const std::string &ordering, int part_size) {
+  if (ordering == "degree") {
+    return from_sequence(degree_sequence(graph));
+  }
+  if (ordering == "bfs") {
+    return from_sequence(bfs_sequence(graph));
+  }
+  if (ordering == "cuthill_mckee") {
+    return from_sequence(cuthill_mckee_sequence(graph));
+  }
+  if (ordering == "partition") {
+    return from_sequence(partition_sequence(graph, std::max(1, part_size)));
+  }
+  std::vector<int> identity(graph.V);
+  std::iota(identity.begin(), identity.end(), 0);
+  return from_sequence(std::move(identity));
+}
+
+Csr_graph reorder(const Csr_graph &graph, const Vertex_order &order) {
+  // edges (first < second) sorted by first, then second, which the edge
+  // list constructor turns into sorted neighbour lists
+  std::vector<Edge> edges;
+  edges.reserve(graph.arcs() / 2);
+  std::vector<int_pair> higher;
+  for (int vertex = 0; vertex < graph.V; vertex++) {
+    int old_vertex = order.to_old(vertex);
+    higher.clear();
+    for (long long arc = graph.offsets[old_vertex];
+         arc < graph.offsets[old_vertex + 1]; arc++) {
+      int target = order.to_new(graph.targets[arc]);
+      if (target > vertex) {
+        higher.push_back({target, graph.weights[arc]});
+      }
+    }
+    std::sort(higher.begin(), higher.end());
+    for (auto &elem : higher) {
+      edges.push_back({vertex, elem.first, elem.second});
+    }
+  }
+  return Csr_graph(graph.V, edges);
+}
+
+std::vector<Edge> reorder(const std::vector<Edge> &edges,
+                          const Vertex_order &order) {
+  std::vector<Edge> reordered(edges.size());
+  for (size_t i = 0; i < edges.size(); i++) {
+    int first = order.to_new(edges[i].first_vertex);
+    int second = order.to_new(edges[i].second_vertex);
+    reordered[i] = {std::min(first, second), std::max(first, second),
+                    edges[i].weight};
+  }
+  std::sort(reordered.begin(), reordered.end(),
+            [](const Edge &a, const Edge &b) {
+              return a.first_vertex != b.first_vertex
+                         ? a.first_vertex < b.first_vertex
+                         : a.second_vertex < b.second_vertex;
+            });
+  return reordered;
+}
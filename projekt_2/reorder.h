@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "csr_graph.h"
+#include "delta_stepping.h"
+#include "graph_generator.h"
+#include <string>
+#include <vector>
+
+// Relabeling of the vertices of a graph. Algorithms run on the reordered
+// graph, the order translates query ids into it and results back out of it.
+struct Vertex_order {
+  std::vector<int> new_id; // new id of every original vertex
+  std::vector<int> old_id; // original id of every new vertex
+
+  int to_new(int vertex) const { return new_id[vertex]; }
+  int to_old(int vertex) const { return old_id[vertex]; }
+
+  // distances and parents computed on the reordered graph, indexed and
+  // labeled by original ids
+  Sssp_result to_original(const Sssp_result &result) const;
+  std::vector<int> to_original(const std::vector<int> &path) const;
+};
+
+// Orderings, all of them deterministic:
+//   identity       keeps the ids
+//   degree         highest degree first, the hubs share cache lines
+//   bfs            breadth first order, component by component
+//   cuthill_mckee  reverse Cuthill-McKee from a pseudo-peripheral vertex,
+//                  neighbours visited by increasing degree, small bandwidth
+//   partition      greedy graph growing into parts of part_size vertices,
+//                  numbered part by part so each part stays in cache
+bool is_vertex_ordering(const std::string &name);
+Vertex_order compute_vertex_order(const Csr_graph &graph,
+                                  const std::string &ordering,
+                                  int part_size = 4096);
+
+// the graph under the new ids, every neighbour list sorted by id
+Csr_graph reorder(const Csr_graph &graph, const Vertex_order &order);
+std::vector<Edge> reorder(const std::vector<Edge> &edges,
+                          const Vertex_order &order);
+
+#endif // !REORDER_H
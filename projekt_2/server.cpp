@@ -0,0 +1,378 @@
+#include "batch_queries.h"
+#include "csr_graph.h"
+#include "graph_generator.h"
+#include "graph_io.h"
+#include "latency_histogram.h"
+#include "reorder.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono;
+
+/*
+
+ Resident shortest path server. The graph is loaded or generated once, then
+ every line "<source> <destination>" is answered with
+ "<distance> <source> ... <destination>" or "none" when there is no path.
+ "stats" answers with the latency percentiles and queries/s, "quit" closes
+ the connection.
+
+   shortest_path_server (--graph <file.bin|file.gr|file.txt> |
+                         --generate <vertices> <edges> <seed>)
+                        [--socket <path>] [--threads N] [--batch 64]
+                        [--order identity|degree|bfs|cuthill_mckee|partition]
+
+ Without --socket the queries come from stdin and the answers go to stdout.
+ Queries of all connections are collected into batches of up to --batch
+ queries, which are answered by a Batch_solver on --threads workers. The
+ latency of a query is measured from reading it to having its answer.
+ With --order the graph is relabeled for locality after loading, queries
+ and paths keep using the original vertex ids.
+
+*/
+
+namespace {
+
+struct Pending_query {
+  int source, destination;
+  steady_clock::time_point arrival;
+  std::promise<std::string> answer;
+};
+
+class Query_server {
+  const Csr_graph &graph;
+  const Vertex_order *order; // nullptr when the graph keeps its ids
+  Batch_solver solver;
+  size_t max_batch;
+
+  std::mutex mutex;
+  std::condition_variable queued;
+  std::deque<Pending_query *> waiting;
+  bool stopping = false;
+  std::thread batcher;
+
+  Latency_histogram latencies;
+  steady_clock::time_point started = steady_clock::now();
+  steady_clock::time_point last_stats = started;
+  long long queries_at_last_stats = 0;
+  std::mutex stats_mutex;
+
+  void batch_loop();
+
+public:
+  Query_server(const Csr_graph &graph, int threads, size_t max_batch,
+               const Vertex_order *order = nullptr)
+      : graph(graph), order(order), solver(graph, threads),
+        max_batch(max_batch),
+        batcher(&Query_server::batch_loop, this) {}
+  ~Query_server();
+
+  // answer to one request line, ready once its batch has run
+  std::future<std::string> submit(const std::string &line);
+  std::string stats();
+  // reads request lines from `in` and writes the answers in the same order
+  void serve(FILE *in, FILE *out);
+};
+
+Query_server::~Query_server() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queued.notify_one();
+  batcher.join();
+}
+
+void Query_server::batch_loop() {
+  std::vector<Pending_query *> batch;
+  std::vector<int_pair> pairs;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      queued.wait(lock, [&] { return stopping || !waiting.empty(); });
+      if (waiting.empty()) {
+        return;
+      }
+      // everything that arrived while the previous batch ran
+      batch.clear();
+      while (!waiting.empty() && batch.size() < max_batch) {
+        batch.push_back(waiting.front());
+        waiting.pop_front();
+      }
+    }
+
+    pairs.clear();
+    for (Pending_query *query : batch) {
+      pairs.emplace_back(query->source, query->destination);
+    }
+    std::vector<Query_answer> answers = solver.solve_pairs(pairs);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      std::string text;
+      if (answers[i].distance == unreached_distance) {
+        text = "none";
+      } else {
+        text = std::to_string(answers[i].distance);
+        if (order) {
+          answers[i].path = order->to_original(answers[i].path);
+        }
+        for (int vertex : answers[i].path) {
+          text += " " + std::to_string(vertex);
+        }
+      }
+      latencies.record(
+          duration_cast<nanoseconds>(steady_clock::now() - batch[i]->arrival)
+              .count());
+      batch[i]->answer.set_value(text);
+      delete batch[i];
+    }
+  }
+}
+
+std::future<std::string> Query_server::submit(const std::string &line) {
+  std::promise<std::string> immediate;
+  int source, destination;
+  char rest;
+  if (line == "stats") {
+    immediate.set_value(stats());
+    return immediate.get_future();
+  }
+  if (std::sscanf(line.c_str(), "%d %d %c", &source, &destination, &rest) !=
+          2 ||
+      source < 0 || source >= graph.V || destination < 0 ||
+      destination >= graph.V) {
+    immediate.set_value("error expected \"<source> <destination>\" with "
+                        "vertices in [0, " +
+                        std::to_string(graph.V) + ")");
+    return immediate.get_future();
+  }
+
+  Pending_query *query = new Pending_query;
+  query->source = order ? order->to_new(source) : source;
+  query->destination = order ? order->to_new(destination) : destination;
+  query->arrival = steady_clock::now();
+  std::future<std::string> answer = query->answer.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    waiting.push_back(query);
+  }
+  queued.notify_one();
+  return answer;
+}
+
+std::string Query_server::stats() {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  steady_clock::time_point now = steady_clock::now();
+  long long answered = latencies.count();
+  double overall = answered / duration<double>(now - started).count();
+  double recent = (answered - queries_at_last_stats) /
+                  duration<double>(now - last_stats).count();
+  last_stats = now;
+  queries_at_last_stats = answered;
+
+  char rates[96];
+  std::snprintf(rates, sizeof(rates), " qps %.1f recent_qps %.1f", overall,
+                recent);
+  return latencies.summary() + rates;
+}
+
+void Query_server::serve(FILE *in, FILE *out) {
+  std::mutex answers_mutex;
+  std::condition_variable answers_ready;
+  std::deque<std::future<std::string>> answers;
+  bool reading = true;
+  std::atomic<bool> write_failed(false);
+
+  // writes answers in request order while the reader keeps submitting, so
+  // one connection can have many queries in the same batch
+  std::thread writer([&] {
+    while (true) {
+      std::future<std::string> answer;
+      {
+        std::unique_lock<std::mutex> lock(answers_mutex);
+        answers_ready.wait(lock, [&] { return !reading || !answers.empty(); });
+        if (answers.empty()) {
+          return;
+        }
+        answer = std::move(answers.front());
+        answers.pop_front();
+      }
+      std::string text = answer.get();
+      bool written = std::fputs(text.c_str(), out) != EOF &&
+                     std::fputc('\n', out) != EOF;
+      {
+        std::lock_guard<std::mutex> lock(answers_mutex);
+        if (written && answers.empty()) {
+          written = std::fflush(out) == 0;
+        }
+      }
+      if (!written) {
+        // the client is gone, stop reading its requests as well; shutdown
+        // wakes a reader blocked on a socket and fails on other files
+        write_failed = true;
+        shutdown(fileno(in), SHUT_RD);
+        return;
+      }
+    }
+  });
+
+  char buffer[256];
+  while (!write_failed && std::fgets(buffer, sizeof(buffer), in) != nullptr) {
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      continue;
+    }
+    if (line == "quit") {
+      break;
+    }
+    std::future<std::string> answer = submit(line);
+    std::lock_guard<std::mutex> lock(answers_mutex);
+    answers.push_back(std::move(answer));
+    answers_ready.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(answers_mutex);
+    reading = false;
+  }
+  answers_ready.notify_one();
+  writer.join();
+  std::fflush(out);
+}
+
+int serve_socket(Query_server &server, const std::string &path) {
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (listener == -1 || path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Could not create the socket " << path << "\n";
+    return 1;
+  }
+  std::strcpy(address.sun_path, path.c_str());
+  unlink(path.c_str());
+  if (bind(listener, (sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(listener, 64) != 0) {
+    std::cerr << "Could not listen on " << path << "\n";
+    close(listener);
+    return 1;
+  }
+  std::cerr << "Listening on " << path << "\n";
+
+  while (true) {
+    int connection = accept(listener, nullptr, nullptr);
+    if (connection == -1) {
+      continue;
+    }
+    std::thread([&server, connection] {
+      FILE *in = fdopen(connection, "r");
+      FILE *out = fdopen(dup(connection), "w");
+      if (in != nullptr && out != nullptr) {
+        server.serve(in, out);
+      }
+      if (out != nullptr) {
+        std::fclose(out);
+      }
+      if (in != nullptr) {
+        std::fclose(in);
+      }
+    }).detach();
+  }
+}
+
+int print_usage() {
+  std::cerr << "usage: shortest_path_server (--graph <file> | --generate "
+               "<vertices> <edges> <seed>)\n"
+               "                            [--socket <path>] [--threads N] "
+               "[--batch 64]\n"
+               "                            [--order identity|degree|bfs|"
+               "cuthill_mckee|partition]\n";
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // a client closing its connection early makes writes fail with EPIPE
+  // instead of killing the server, serve then drops that client
+  std::signal(SIGPIPE, SIG_IGN);
+
+  std::string graph_path, socket_path, ordering;
+  int vertices = 0;
+  long long edges = 0;
+  unsigned long long seed = 0;
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t batch = 64;
+
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    if (option == "--graph" && i + 1 < argc) {
+      graph_path = argv[++i];
+    } else if (option == "--generate" && i + 3 < argc) {
+      vertices = std::atoi(argv[++i]);
+      edges = std::atoll(argv[++i]);
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (option == "--socket" && i + 1 < argc) {
+      socket_path = argv[++i];
+    } else if (option == "--threads" && i + 1 < argc) {
+      threads = std::max(1, std::atoi(argv[++i]));
+    } else if (option == "--batch" && i + 1 < argc) {
+      batch = std::max(1, std::atoi(argv[++i]));
+    } else if (option == "--order" && i + 1 < argc &&
+               is_vertex_ordering(argv[i + 1])) {
+      ordering = argv[++i];
+    } else {
+      return print_usage();
+    }
+  }
+
+  Csr_graph graph;
+  steady_clock::time_point begin = steady_clock::now();
+  if (!graph_path.empty()) {
+    if (!load_graph(graph_path, graph)) {
+      std::cerr << "Could not load the graph from " << graph_path << "\n";
+      return 1;
+    }
+  } else if (vertices > 0) {
+    Graph_generator generator(vertices, edges, seed, threads);
+    graph = Csr_graph(vertices, generator.generate());
+  } else {
+    return print_usage();
+  }
+  Vertex_order order;
+  if (!ordering.empty()) {
+    order = compute_vertex_order(graph, ordering);
+    Csr_graph reordered = reorder(graph, order);
+    graph = std::move(reordered);
+  }
+  steady_clock::time_point end = steady_clock::now();
+  std::cerr << "|V| = " << graph.V << "\tE = " << graph.arcs() / 2
+            << "\tready after "
+            << duration_cast<microseconds>(end - begin).count() << " us\n";
+
+  Query_server server(graph, threads, batch,
+                      ordering.empty() ? nullptr : &order);
+  if (!socket_path.empty()) {
+    return serve_socket(server, socket_path);
+  }
+  server.serve(stdin, stdout);
+  std::cerr << server.stats() << "\n";
+  return 0;
+}
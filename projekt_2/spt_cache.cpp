@@ -0,0 +1,240 @@
+#include "spt_cache.h"
+#include "dijkstra.h"
+#include <functional>
+#include <queue>
+
+typedef std::priority_queue<int_pair, std::vector<int_pair>,
+                            std::greater<int_pair>>
+    min_queue;
+
+Spt_cache::Spt_cache(Graph &graph, size_t memory_limit)
+    : graph(graph), memory_limit(memory_limit),
+      scratch_mark(graph.vertices(), 0) {}
+
+namespace {
+
+// adjacency policy over Graph::neighbours, for any representation
+struct Neighbours_adjacency {
+  const Graph &graph;
+  std::vector<int_pair> &scratch;
+
+  template <class Visit>
+  void for_each_neighbour(int vertex, Visit visit) const {
+    graph.neighbours(vertex, scratch);
+    for (auto &elem : scratch) {
+      visit(elem.first, elem.second);
+    }
+  }
+};
+
+} // namespace
+
+Shortest_path_tree Spt_cache::compute(int source) {
+  Distance_vector distances(graph.vertices(), unreached_distance);
+  Binary_heap_queue queue;
+  Record_parents paths(graph.vertices());
+  dijkstra(Neighbours_adjacency{graph, scratch_neighbours}, source, distances,
+           queue, All_targets(), paths);
+
+  Shortest_path_tree tree;
+  tree.source = source;
+  tree.distances = std::move(distances.values);
+  tree.parents = std::move(paths.parents);
+  return tree;
+}
+
+const Shortest_path_tree &Spt_cache::tree(int source) {
+  auto found = by_source.find(source);
+  if (found != by_source.end()) {
+    hits++;
+    trees.splice(trees.begin(), trees, found->second);
+    return trees.front();
+  }
+
+  misses++;
+  trees.push_front(compute(source));
+  by_source[source] = trees.begin();
+  memory_used += trees.front().memory_bytes();
+  // the tree just computed always stays
+  while (memory_used > memory_limit && trees.size() > 1) {
+    memory_used -= trees.back().memory_bytes();
+    by_source.erase(trees.back().source);
+    trees.pop_back();
+  }
+  return trees.front();
+}
+
+/*
+
+ REPAIRS
+
+*/
+
+int Spt_cache::best_parent(const Shortest_path_tree &tree, int vertex) {
+  int distance = tree.distances[vertex];
+  if (vertex == tree.source || distance == unreached_distance) {
+    return -1;
+  }
+  int best = -1;
+  graph.neighbours(vertex, scratch_neighbours);
+  for (auto &elem : scratch_neighbours) {
+    int neighbour = elem.first;
+    if ((long long)tree.distances[neighbour] + elem.second != distance) {
+      continue;
+    }
+    if (best == -1 || tree.distances[neighbour] < tree.distances[best] ||
+        (tree.distances[neighbour] == tree.distances[best] &&
+         neighbour < best)) {
+      best = neighbour;
+    }
+  }
+  return best;
+}
+
+void Spt_cache::rechoose_parents(Shortest_path_tree &tree,
+                                 const std::vector<int> &changed) {
+  // a changed distance can make a vertex a better tie for its neighbours
+  mark_generation++;
+  std::vector<int> candidates;
+  for (int vertex : changed) {
+    if (scratch_mark[vertex] != mark_generation) {
+      scratch_mark[vertex] = mark_generation;
+      candidates.push_back(vertex);
+    }
+    graph.neighbours(vertex, scratch_neighbours);
+    for (auto &elem : scratch_neighbours) {
+      if (scratch_mark[elem.first] != mark_generation) {
+        scratch_mark[elem.first] = mark_generation;
+        candidates.push_back(elem.first);
+      }
+    }
+  }
+  for (int vertex : candidates) {
+    tree.parents[vertex] = best_parent(tree, vertex);
+  }
+}
+
+void Spt_cache::repair_decrease(Shortest_path_tree &tree, int first_vertex,
+                                int second_vertex, int weight) {
+  std::vector<int> changed = {first_vertex, second_vertex};
+  min_queue pq;
+  // summed wide, an unreached endpoint holds INT_MAX
+  long long through_first = (long long)tree.distances[first_vertex] + weight;
+  long long through_second = (long long)tree.distances[second_vertex] + weight;
+  if (through_first < tree.distances[second_vertex]) {
+    tree.distances[second_vertex] = through_first;
+    pq.emplace(tree.distances[second_vertex], second_vertex);
+  } else if (through_second < tree.distances[first_vertex]) {
+    tree.distances[first_vertex] = through_second;
+    pq.emplace(tree.distances[first_vertex], first_vertex);
+  }
+
+  while (!pq.empty()) {
+    int min_distance = pq.top().first;
+    int min_distance_vertex = pq.top().second;
+    pq.pop();
+    if (min_distance > tree.distances[min_distance_vertex]) {
+      continue;
+    }
+    graph.neighbours(min_distance_vertex, scratch_neighbours);
+    for (auto &elem : scratch_neighbours) {
+      long long next_check = (long long)min_distance + elem.second;
+      if (tree.distances[elem.first] > next_check) {
+        tree.distances[elem.first] = next_check;
+        changed.push_back(elem.first);
+        pq.emplace(next_check, elem.first);
+      }
+    }
+  }
+  rechoose_parents(tree, changed);
+}
+
+void Spt_cache::repair_increase(Shortest_path_tree &tree, int first_vertex,
+                                int second_vertex) {
+  int child;
+  if (tree.parents[second_vertex] == first_vertex) {
+    child = second_vertex;
+  } else if (tree.parents[first_vertex] == second_vertex) {
+    child = first_vertex;
+  } else {
+    return; // another tight neighbour stays the parent, nothing moves
+  }
+
+  // the subtree below the edge, the only vertices whose distance can grow
+  mark_generation++;
+  std::vector<int> affected = {child};
+  scratch_mark[child] = mark_generation;
+  for (size_t i = 0; i < affected.size(); i++) {
+    graph.neighbours(affected[i], scratch_neighbours);
+    for (auto &elem : scratch_neighbours) {
+      if (tree.parents[elem.first] == affected[i] &&
+          scratch_mark[elem.first] != mark_generation) {
+        scratch_mark[elem.first] = mark_generation;
+        affected.push_back(elem.first);
+      }
+    }
+  }
+
+  // best distance through an unaffected neighbour
+  min_queue pq;
+  for (int vertex : affected) {
+    long long distance = unreached_distance;
+    graph.neighbours(vertex, scratch_neighbours);
+    for (auto &elem : scratch_neighbours) {
+      if (scratch_mark[elem.first] != mark_generation) {
+        distance = std::min(distance, (long long)tree.distances[elem.first] +
+                                          elem.second);
+      }
+    }
+    tree.distances[vertex] = distance;
+    if (distance < unreached_distance) {
+      pq.emplace(distance, vertex);
+    }
+  }
+
+  // settle the subtree, vertices outside keep their distances
+  while (!pq.empty()) {
+    int min_distance = pq.top().first;
+    int min_distance_vertex = pq.top().second;
+    pq.pop();
+    if (min_distance > tree.distances[min_distance_vertex]) {
+      continue;
+    }
+    graph.neighbours(min_distance_vertex, scratch_neighbours);
+    for (auto &elem : scratch_neighbours) {
+      long long next_check = (long long)min_distance + elem.second;
+      if (scratch_mark[elem.first] == mark_generation &&
+          tree.distances[elem.first] > next_check) {
+        tree.distances[elem.first] = next_check;
+        pq.emplace(next_check, elem.first);
+      }
+    }
+  }
+  // parents outside the subtree are not in it and keep being the best tie
+  for (int vertex : affected) {
+    tree.parents[vertex] = best_parent(tree, vertex);
+  }
+}
+
+void Spt_cache::update_edge(int first_vertex, int second_vertex, int weight) {
+  int old_weight = graph.edge_weight(first_vertex, second_vertex);
+  if (weight == old_weight) {
+    return;
+  }
+  if (weight == 0) {
+    graph.remove_edge(first_vertex, second_vertex);
+  } else if (old_weight == 0) {
+    graph.insert_edge(first_vertex, second_vertex, weight);
+  } else {
+    graph.update_edge(first_vertex, second_vertex, weight);
+  }
+
+  bool lighter = old_weight == 0 || (weight != 0 && weight < old_weight);
+  for (Shortest_path_tree &tree : trees) {
+    if (lighter) {
+      repair_decrease(tree, first_vertex, second_vertex, weight);
+    } else {
+      repair_increase(tree, first_vertex, second_vertex);
+    }
+  }
+}
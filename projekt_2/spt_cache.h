@@ -0,0 +1,71 @@
+#pragma once
+
+#ifndef SPT_CACHE_H
+#define SPT_CACHE_H
+
+#include "graph.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// distances and parents from one source: unreached_distance (dijkstra.h) for
+// unreached vertices, the smallest (distance, id) tight neighbour as parent
+// and -1 for the source and unreached vertices
+struct Shortest_path_tree {
+  int source;
+  std::vector<int> distances;
+  std::vector<int> parents;
+
+  size_t memory_bytes() const {
+    return sizeof(*this) + (distances.size() + parents.size()) * sizeof(int);
+  }
+};
+
+// Shortest path trees of recently asked sources, dropped least recently used
+// first once they take more than memory_limit bytes. Edge updates go through
+// the cache, which changes the graph and then repairs every cached tree in
+// the spirit of Ramalingam & Reps instead of recomputing it:
+//  - a lighter or new edge starts a Dijkstra from the endpoint it improves,
+//    visiting only vertices whose distance drops,
+//  - a heavier or removed tree edge invalidates the subtree below it, which
+//    is re-seeded from its unaffected neighbours and settled by a Dijkstra
+//    limited to the subtree,
+//  - heavier non-tree edges change nothing.
+// Parents are then rechosen only around the vertices whose distance changed,
+// so a repaired tree is identical to a fresh one.
+class Spt_cache {
+  Graph &graph;
+  size_t memory_limit;
+  size_t memory_used = 0;
+  std::list<Shortest_path_tree> trees; // most recently used first
+  std::unordered_map<int, std::list<Shortest_path_tree>::iterator> by_source;
+  std::vector<int_pair> scratch_neighbours;
+  std::vector<int> scratch_mark; // per vertex, equal to mark_generation when set
+  int mark_generation = 0;
+
+  int best_parent(const Shortest_path_tree &tree, int vertex);
+  void repair_decrease(Shortest_path_tree &tree, int first_vertex,
+                       int second_vertex, int weight);
+  void repair_increase(Shortest_path_tree &tree, int first_vertex,
+                       int second_vertex);
+  void rechoose_parents(Shortest_path_tree &tree,
+                        const std::vector<int> &changed);
+
+public:
+  long long hits = 0, misses = 0;
+
+  Spt_cache(Graph &graph, size_t memory_limit);
+
+  // full Dijkstra over graph.neighbours, the reference for repaired trees
+  Shortest_path_tree compute(int source);
+
+  // cached tree of source, computed (and possibly evicting others) on a miss
+  const Shortest_path_tree &tree(int source);
+  size_t size() const { return trees.size(); }
+
+  // sets the weight of the edge, 0 removes it and a missing edge is inserted
+  void update_edge(int first_vertex, int second_vertex, int weight);
+};
+
+#endif // !SPT_CACHE_H
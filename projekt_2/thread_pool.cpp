@@ -0,0 +1,78 @@
+#include "thread_pool.h"
+
+Thread_pool::Thread_pool(int threads) {
+  for (int worker = 1; worker < threads; worker++) {
+    workers.emplace_back(&Thread_pool::worker_loop, this, worker);
+  }
+}
+
+Thread_pool::~Thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  job_ready.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void Thread_pool::worker_loop(int worker) {
+  long long seen_generation = 0;
+  while (true) {
+    const std::function<void(int)> *current_job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_ready.wait(lock, [&] {
+        return stopping || generation != seen_generation;
+      });
+      if (stopping) {
+        return;
+      }
+      seen_generation = generation;
+      current_job = job;
+    }
+
+    (*current_job)(worker);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--running == 0) {
+      job_done.notify_one();
+    }
+  }
+}
+
+void Thread_pool::run(const std::function<void(int)> &job) {
+  if (workers.empty()) {
+    job(0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->job = &job;
+    running = workers.size();
+    generation++;
+  }
+  job_ready.notify_all();
+
+  job(0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  job_done.wait(lock, [&] { return running == 0; });
+}
+
+void Thread_pool::parallel_for(
+    long long count,
+    const std::function<void(long long, long long, int)> &body) {
+  int chunks = size();
+  if (chunks == 1 || count < chunks) {
+    body(0, count, 0);
+    return;
+  }
+  run([&](int worker) {
+    long long begin = count * worker / chunks;
+    long long end = count * (worker + 1) / chunks;
+    body(begin, end, worker);
+  });
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that all run the same job and are joined
+// again before run() returns. The calling thread takes part as worker 0, so
+// a pool of size 1 spawns no threads at all.
+class Thread_pool {
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable job_ready, job_done;
+  const std::function<void(int)> *job = nullptr;
+  long long generation = 0; // incremented for every job
+  int running = 0;          // workers still busy with the current job
+  bool stopping = false;
+
+  void worker_loop(int worker);
+
+public:
+  explicit Thread_pool(int threads);
+  ~Thread_pool();
+  Thread_pool(const Thread_pool &) = delete;
+  Thread_pool &operator=(const Thread_pool &) = delete;
+
+  int size() const { return workers.size() + 1; }
+
+  // calls job(worker) once on every worker, worker in [0, size())
+  void run(const std::function<void(int)> &job);
+
+  // splits [0, count) into size() contiguous chunks and calls
+  // body(begin, end, worker) for each of them
+  void parallel_for(long long count,
+                    const std::function<void(long long, long long, int)> &body);
+};
+
+#endif // !THREAD_POOL_H